@@ -0,0 +1,23 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <print>
+
+namespace Magma::Bench {
+
+/** Runs body `rounds` times and returns the mean nanoseconds per item */
+template <typename F>
+double nsPerItem(uint32_t rounds, uint64_t itemsPerRound, F &&body) {
+  body(); // warm caches and branch predictors
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < rounds; ++r) body();
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / (static_cast<double>(rounds) * itemsPerRound);
+}
+
+inline void report(const char *name, double ns, double baselineNs) {
+  std::println("  {:<28} {:>10.2f} ns  {:>6.2f}x", name, ns, baselineNs / ns);
+}
+
+} // namespace Magma::Bench
@@ -0,0 +1,69 @@
+#include "bench.hpp"
+#include "engine/gameobject.hpp"
+#include "engine/scene.hpp"
+#include <functional>
+#include <random>
+#include <vector>
+
+// GameObject lookup by id in a 100k object scene: the depth first search
+// SceneManager::findGameObjectById used to run against the Scene's index
+
+using namespace Magma;
+
+namespace {
+
+constexpr uint32_t ROOTS = 1'000;
+constexpr uint32_t OBJECTS = 100'000;
+constexpr uint32_t SEARCHES = 200;
+constexpr uint32_t LOOKUPS = 100'000;
+
+// SceneManager::findGameObjectById before the index
+GameObject *findBySearch(Scene &scene, GameObject::id_t id) {
+  std::function<GameObject *(GameObject *)> findInChildren =
+      [&](GameObject *node) -> GameObject * {
+    if (!node) return nullptr;
+    if (node->id == id) return node;
+    for (auto *child : node->getChildren())
+      if (auto *found = findInChildren(child)) return found;
+    return nullptr;
+  };
+
+  for (const auto &go : scene.getGameObjects()) {
+    if (!go) continue;
+    if (go->id == id) return go.get();
+    if (auto *found = findInChildren(go.get())) return found;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+int main() {
+  // Roots with random subtrees below them, a few levels deep
+  Scene scene("Benchmark");
+  std::mt19937 rng{42};
+  std::vector<GameObject *> objects;
+  objects.reserve(OBJECTS);
+  for (uint32_t i = 0; i < ROOTS; ++i) objects.push_back(scene.createGameObject());
+  while (objects.size() < OBJECTS) {
+    std::uniform_int_distribution<size_t> pick{objects.size() / 2, objects.size() - 1};
+    objects.push_back(scene.createGameObject(objects[pick(rng)]));
+  }
+
+  std::uniform_int_distribution<size_t> pick{0, objects.size() - 1};
+  std::vector<GameObject::id_t> ids(LOOKUPS);
+  for (auto &id : ids) id = objects[pick(rng)]->id;
+
+  uint64_t found = 0;
+  const double search = Bench::nsPerItem(1, SEARCHES, [&] {
+    for (uint32_t i = 0; i < SEARCHES; ++i) found += findBySearch(scene, ids[i]) != nullptr;
+  });
+  const double index = Bench::nsPerItem(10, LOOKUPS, [&] {
+    for (GameObject::id_t id : ids) found += scene.findGameObject(id) != nullptr;
+  });
+
+  std::println("GameObject lookup, {} objects under {} roots", OBJECTS, ROOTS);
+  Bench::report("depth first search", search, search);
+  Bench::report("scene index", index, search);
+  std::println("  (found {})", found);
+}
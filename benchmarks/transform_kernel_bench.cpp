@@ -0,0 +1,97 @@
+#include "bench.hpp"
+#include "core/transform_kernel.hpp"
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+// Local matrices of many transforms: the per-object path every Transform
+// used to take, six sin/cos for the model matrix and six more for the
+// normal matrix, against TransformKernel one lane at a time and batched
+
+using namespace Magma;
+
+namespace {
+
+constexpr uint32_t COUNT = 10'000;
+constexpr uint32_t ROUNDS = 500;
+
+struct Streams {
+  std::vector<float> values[9];
+  TransformStreams view(uint32_t offset = 0) const {
+    return {values[0].data() + offset, values[1].data() + offset, values[2].data() + offset,
+            values[3].data() + offset, values[4].data() + offset, values[5].data() + offset,
+            values[6].data() + offset, values[7].data() + offset, values[8].data() + offset};
+  }
+};
+
+// Transform::modelMatrix and normalMatrix before the kernel
+void composePerObject(const Streams &s, uint32_t i, glm::mat4 &model, glm::mat3x4 &normal) {
+  const float px = s.values[0][i], py = s.values[1][i], pz = s.values[2][i];
+  const float rx = s.values[3][i], ry = s.values[4][i], rz = s.values[5][i];
+  const float sx = s.values[6][i], sy = s.values[7][i], sz = s.values[8][i];
+  {
+    const float c1 = std::cos(ry), s1 = std::sin(ry);
+    const float c2 = std::cos(rx), s2 = std::sin(rx);
+    const float c3 = std::cos(rz), s3 = std::sin(rz);
+    model = glm::mat4{{sx * (c1 * c3 + s1 * s2 * s3), sx * c2 * s3, sx * (c1 * s2 * s3 - s1 * c3), 0.f},
+                      {sy * (s1 * s2 * c3 - s3 * c1), sy * c2 * c3, sy * (s1 * s3 + c1 * s2 * c3), 0.f},
+                      {sz * s1 * c2, sz * -s2, sz * c1 * c2, 0.f},
+                      {px, py, pz, 1.f}};
+  }
+  {
+    const float c1 = std::cos(ry), s1 = std::sin(ry);
+    const float c2 = std::cos(rx), s2 = std::sin(rx);
+    const float c3 = std::cos(rz), s3 = std::sin(rz);
+    const float ix = 1.f / sx, iy = 1.f / sy, iz = 1.f / sz;
+    normal = glm::mat3x4{{ix * (c1 * c3 + s1 * s2 * s3), ix * c2 * s3, ix * (c1 * s2 * s3 - s1 * c3), 0.f},
+                         {iy * (s1 * s2 * c3 - s3 * c1), iy * c2 * c3, iy * (s1 * s3 + c1 * s2 * c3), 0.f},
+                         {iz * s1 * c2, iz * -s2, iz * c1 * c2, 0.f}};
+  }
+}
+
+float checksum(const std::vector<glm::mat4> &models, const std::vector<glm::mat3x4> &normals) {
+  float sum = 0.f;
+  for (uint32_t i = 0; i < COUNT; ++i) sum += models[i][0][0] + models[i][2][1] + normals[i][1][2];
+  return sum;
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<float> position{-100.f, 100.f};
+  std::uniform_real_distribution<float> angle{-std::numbers::pi_v<float>, std::numbers::pi_v<float>};
+  std::uniform_real_distribution<float> scale{0.5f, 2.f};
+
+  Streams streams;
+  for (uint32_t v = 0; v < 9; ++v) {
+    streams.values[v].resize(COUNT);
+    for (float &value : streams.values[v])
+      value = v < 3 ? position(rng) : v < 6 ? angle(rng) : scale(rng);
+  }
+  std::vector<glm::mat4> models(COUNT);
+  std::vector<glm::mat3x4> normals(COUNT);
+  float sink = 0.f;
+
+  const double perObject = Bench::nsPerItem(ROUNDS, COUNT, [&] {
+    for (uint32_t i = 0; i < COUNT; ++i) composePerObject(streams, i, models[i], normals[i]);
+    sink += checksum(models, normals);
+  });
+  const double singleLane = Bench::nsPerItem(ROUNDS, COUNT, [&] {
+    for (uint32_t i = 0; i < COUNT; ++i)
+      TransformKernel::compose(streams.view(i), 1, &models[i], &normals[i]);
+    sink += checksum(models, normals);
+  });
+  const double batched = Bench::nsPerItem(ROUNDS, COUNT, [&] {
+    TransformKernel::compose(streams.view(), COUNT, models.data(), normals.data());
+    sink += checksum(models, normals);
+  });
+
+  std::println("Transform compose, {} transforms x {} rounds, kernel path {}", COUNT, ROUNDS,
+               TransformKernel::simdPath());
+  Bench::report("per object (std::sin/cos)", perObject, perObject);
+  Bench::report("kernel, one lane per call", singleLane, perObject);
+  Bench::report("kernel, batched", batched, perObject);
+  std::println("  (checksum {})", sink);
+}
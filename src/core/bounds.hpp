@@ -0,0 +1,45 @@
+#pragma once
+#include "mesh_data.hpp"
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <limits>
+#include <span>
+
+namespace Magma {
+
+/**
+ * Axis aligned box of a mesh plus the radius of the sphere around the box
+ * center enclosing every vertex, which is usually tighter than the box's
+ * circumscribed sphere. Culling tests both against one center.
+ */
+struct Bounds {
+  glm::vec3 min{0.f};
+  glm::vec3 max{0.f};
+  float radius = 0.f;
+
+  glm::vec3 center() const { return (min + max) * 0.5f; }
+  glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+  static Bounds fromVertices(std::span<const MeshData::Vertex> vertices) {
+    Bounds bounds;
+    if (vertices.empty()) return bounds;
+
+    bounds.min = glm::vec3{std::numeric_limits<float>::max()};
+    bounds.max = glm::vec3{std::numeric_limits<float>::lowest()};
+    for (const MeshData::Vertex &vertex : vertices) {
+      bounds.min = glm::min(bounds.min, vertex.position);
+      bounds.max = glm::max(bounds.max, vertex.position);
+    }
+
+    const glm::vec3 center = bounds.center();
+    float radiusSquared = 0.f;
+    for (const MeshData::Vertex &vertex : vertices) {
+      const glm::vec3 offset = vertex.position - center;
+      radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+    return bounds;
+  }
+};
+
+} // namespace Magma
@@ -26,19 +26,19 @@ Buffer::Buffer(VkDeviceSize instanceSize, uint32_t instanceCount,
 Buffer::~Buffer() { cleanUp(); }
 
 void Buffer::cleanUp() {
-  if (buffer == VK_NULL_HANDLE && bufferMemory == VK_NULL_HANDLE)
+  if (buffer == VK_NULL_HANDLE && !bufferMemory.valid())
     return;
 
   unmap();
 
   VkBuffer buf = buffer;
-  VkDeviceMemory mem = bufferMemory;
+  Allocation mem = bufferMemory;
   buffer = VK_NULL_HANDLE;
-  bufferMemory = VK_NULL_HANDLE;
+  bufferMemory = {};
 
   DeletionQueue::push([buf, mem](VkDevice device) {
     vkDestroyBuffer(device, buf, nullptr);
-    vkFreeMemory(device, mem, nullptr);
+    Device::freeMemory(mem);
   });
 }
 // --- Public ---
@@ -55,10 +55,13 @@ VkDescriptorBufferInfo Buffer::descriptorInfo() {
 // Memory Operations
 
 VkResult Buffer::map(VkDeviceSize size, VkDeviceSize offset) {
-  assert(buffer && bufferMemory && "Buffer has to be created before mapping!");
+  assert(buffer && bufferMemory.valid() && "Buffer has to be created before mapping!");
 
-  VkDevice device = Device::get().device();
-  return vkMapMemory(device, bufferMemory, offset, size, 0, &mappedMemory);
+  // Host-visible blocks stay mapped for their lifetime, mapping is a lookup
+  if (!bufferMemory.mapped)
+    return VK_ERROR_MEMORY_MAP_FAILED;
+  mappedMemory = static_cast<char *>(bufferMemory.mapped) + offset;
+  return VK_SUCCESS;
 }
 
 void Buffer::writeToBuffer(void *data, VkDeviceSize size, VkDeviceSize offset) {
@@ -74,29 +77,7 @@ void Buffer::writeToBuffer(void *data, VkDeviceSize size, VkDeviceSize offset) {
 }
 
 void Buffer::flush(VkDeviceSize size, VkDeviceSize offset) {
-  VkDevice device = Device::get().device();
-  const VkDeviceSize atom = Device::nonCoherentAtomSize();
-
-  VkMappedMemoryRange mappedRange = {};
-  mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-  mappedRange.memory = bufferMemory;
-
-  if (size == VK_WHOLE_SIZE) {
-    mappedRange.size = VK_WHOLE_SIZE;
-    mappedRange.offset = 0;
-  } else {
-    VkDeviceSize alignedOffset = (offset / atom) * atom;
-    VkDeviceSize end = offset + size;
-    VkDeviceSize alignedEnd = ((end + atom - 1) / atom) * atom;
-    if (alignedEnd > bufferSize)
-      alignedEnd = bufferSize;
-    VkDeviceSize alignedSize = alignedEnd - alignedOffset;
-
-    mappedRange.offset = alignedOffset;
-    mappedRange.size = alignedSize;
-  }
-
-  vkFlushMappedMemoryRanges(device, 1, &mappedRange);
+  Device::allocator().flush(bufferMemory, size, offset);
 }
 
 // --- Private ---
@@ -113,11 +94,7 @@ VkDeviceSize Buffer::getAlignment(VkDeviceSize instanceSize,
 // Memory Operations
 
 void Buffer::unmap() {
-  if (mappedMemory) {
-    VkDevice device = Device::get().device();
-    vkUnmapMemory(device, bufferMemory);
-    mappedMemory = nullptr;
-  };
+  mappedMemory = nullptr;
 }
 
 } // namespace Magma
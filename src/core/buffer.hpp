@@ -1,4 +1,5 @@
 #pragma once
+#include "memory_allocator.hpp"
 #include <cstdint>
 #include <vector>
 #include <vulkan/vulkan_core.h>
@@ -34,7 +35,7 @@ public:
 private:
   // Buffer
   VkBuffer buffer = VK_NULL_HANDLE;
-  VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
+  Allocation bufferMemory{};
   void *mappedMemory = nullptr;
 
   // Buffer properties
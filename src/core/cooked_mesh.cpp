@@ -0,0 +1,153 @@
+#include "cooked_mesh.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace Magma {
+
+static_assert(std::is_trivially_copyable_v<MeshData::Submesh>);
+static_assert(std::is_trivially_copyable_v<MeshData::Lod>);
+static_assert(std::is_trivially_copyable_v<CookedMeshHeader>);
+
+namespace {
+constexpr uint64_t STREAM_ALIGNMENT = 16;
+
+uint64_t alignUp(uint64_t value) {
+  return (value + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+}
+
+bool streamFits(uint64_t offset, uint64_t count, uint64_t stride, uint64_t size) {
+  if (offset % STREAM_ALIGNMENT != 0 || offset > size) return false;
+  return count <= (size - offset) / std::max<uint64_t>(stride, 1);
+}
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+std::unique_ptr<CookedMesh> CookedMesh::fromFile(MappedFile file) {
+  const CookedMeshHeader *header = validate(file.data(), file.size());
+  if (!header) return nullptr;
+
+  std::unique_ptr<CookedMesh> mesh{new CookedMesh()};
+  mesh->file = std::move(file);
+  mesh->base = static_cast<const std::byte *>(mesh->file.data());
+  mesh->header_ = header;
+  return mesh;
+}
+
+std::unique_ptr<CookedMesh> CookedMesh::fromBytes(std::vector<std::byte> bytes) {
+  const CookedMeshHeader *header = validate(bytes.data(), bytes.size());
+  if (!header) return nullptr;
+
+  std::unique_ptr<CookedMesh> mesh{new CookedMesh()};
+  mesh->bytes = std::move(bytes);
+  mesh->base = mesh->bytes.data();
+  mesh->header_ = header;
+  return mesh;
+}
+
+std::vector<std::byte> CookedMesh::serialize(const MeshData &mesh,
+                                             uint64_t sourceHash,
+                                             uint64_t sourceStamp) {
+  CookedMeshHeader header{};
+  std::memcpy(header.magic, CookedMeshHeader::MAGIC, sizeof(header.magic));
+  header.version = CookedMeshHeader::VERSION;
+  const VertexLayout layout = VertexLayouts::select(mesh.vertices);
+  header.vertexLayout = static_cast<uint32_t>(layout);
+  header.vertexStride = VertexLayouts::stride(layout);
+  // Welded meshes usually fit 16-bit indices, halving index fetch bandwidth
+  header.indexSize = mesh.vertices.size() <= 65536 ? sizeof(uint16_t) : sizeof(uint32_t);
+  header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+
+  // Meshes cooked without a chain still get their full index range as LOD 0
+  std::vector<MeshData::Lod> lods = mesh.lods;
+  if (lods.empty() && !mesh.indices.empty())
+    lods.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0.f});
+  header.lodCount = static_cast<uint32_t>(lods.size());
+  header.vertexCount = mesh.vertices.size();
+  header.indexCount = mesh.indices.size();
+  header.sourceHash = sourceHash;
+  header.sourceStamp = sourceStamp;
+
+  header.bounds = Bounds::fromVertices(mesh.vertices);
+
+  const uint64_t vertexBytes = mesh.vertices.size() * header.vertexStride;
+  const uint64_t indexBytes = mesh.indices.size() * header.indexSize;
+  const uint64_t submeshBytes = mesh.submeshes.size() * sizeof(MeshData::Submesh);
+  const uint64_t lodBytes = lods.size() * sizeof(MeshData::Lod);
+  header.vertexOffset = alignUp(sizeof(CookedMeshHeader));
+  header.indexOffset = alignUp(header.vertexOffset + vertexBytes);
+  header.submeshOffset = alignUp(header.indexOffset + indexBytes);
+  header.lodOffset = alignUp(header.submeshOffset + submeshBytes);
+  header.fileSize = header.lodOffset + lodBytes;
+
+  std::vector<std::byte> bytes(header.fileSize);
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  VertexLayouts::encode(layout, mesh.vertices, bytes.data() + header.vertexOffset);
+  if (indexBytes && header.indexSize == sizeof(uint16_t)) {
+    auto *indices = reinterpret_cast<uint16_t *>(bytes.data() + header.indexOffset);
+    for (size_t i = 0; i < mesh.indices.size(); ++i)
+      indices[i] = static_cast<uint16_t>(mesh.indices[i]);
+  } else if (indexBytes) {
+    std::memcpy(bytes.data() + header.indexOffset, mesh.indices.data(), indexBytes);
+  }
+  if (submeshBytes)
+    std::memcpy(bytes.data() + header.submeshOffset, mesh.submeshes.data(), submeshBytes);
+  if (lodBytes)
+    std::memcpy(bytes.data() + header.lodOffset, lods.data(), lodBytes);
+  return bytes;
+}
+
+const CookedMeshHeader *CookedMesh::validate(const void *data, size_t size) {
+  if (!data || size < sizeof(CookedMeshHeader)) return nullptr;
+
+  // Mappings and vector storage are both suitably aligned for the header
+  const auto *header = static_cast<const CookedMeshHeader *>(data);
+  if (std::memcmp(header->magic, CookedMeshHeader::MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != CookedMeshHeader::VERSION ||
+      header->vertexLayout >= VERTEX_LAYOUT_COUNT ||
+      header->vertexStride != VertexLayouts::stride(static_cast<VertexLayout>(header->vertexLayout)) ||
+      (header->indexSize != sizeof(uint16_t) && header->indexSize != sizeof(uint32_t)) ||
+      header->fileSize != size)
+    return nullptr;
+
+  if (!streamFits(header->vertexOffset, header->vertexCount, header->vertexStride, size) ||
+      !streamFits(header->indexOffset, header->indexCount, header->indexSize, size) ||
+      !streamFits(header->submeshOffset, header->submeshCount, sizeof(MeshData::Submesh), size) ||
+      !streamFits(header->lodOffset, header->lodCount, sizeof(MeshData::Lod), size))
+    return nullptr;
+
+  // LOD ranges are drawn as is, so they must stay inside the index stream
+  const auto *lods = reinterpret_cast<const MeshData::Lod *>(
+      static_cast<const std::byte *>(data) + header->lodOffset);
+  for (uint32_t i = 0; i < header->lodCount; ++i)
+    if (lods[i].firstIndex > header->indexCount ||
+        lods[i].indexCount > header->indexCount - lods[i].firstIndex)
+      return nullptr;
+
+  return header;
+}
+
+std::span<const std::byte> CookedMesh::vertexData() const {
+  return {base + header_->vertexOffset,
+          static_cast<size_t>(header_->vertexCount * header_->vertexStride)};
+}
+
+std::span<const std::byte> CookedMesh::indexData() const {
+  return {base + header_->indexOffset,
+          static_cast<size_t>(header_->indexCount * header_->indexSize)};
+}
+
+std::span<const MeshData::Submesh> CookedMesh::submeshes() const {
+  return {reinterpret_cast<const MeshData::Submesh *>(base + header_->submeshOffset),
+          header_->submeshCount};
+}
+
+std::span<const MeshData::Lod> CookedMesh::lods() const {
+  return {reinterpret_cast<const MeshData::Lod *>(base + header_->lodOffset),
+          header_->lodCount};
+}
+
+} // namespace Magma
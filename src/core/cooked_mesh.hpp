@@ -0,0 +1,85 @@
+#pragma once
+#include "bounds.hpp"
+#include "mapped_file.hpp"
+#include "mesh_data.hpp"
+#include "vertex_layout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Magma {
+
+/**
+ * On-disk layout of a `.magmamesh` file: this header followed by the vertex,
+ * index, submesh and LOD streams at the recorded offsets, each 16 byte aligned.
+ * Streams are stored exactly as the GPU consumes them.
+ */
+struct CookedMeshHeader {
+  static constexpr char MAGIC[8] = {'M', 'A', 'G', 'M', 'A', 'M', 'S', 'H'};
+  static constexpr uint32_t VERSION = 6;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t vertexLayout;   // VertexLayout of the vertex stream
+  uint32_t vertexStride;   // VertexLayouts::stride(vertexLayout) when cooked
+  uint32_t indexSize;      // 2 when every index fits in 16 bits, else 4
+  uint32_t submeshCount;
+  uint32_t lodCount;       // at least 1 when the mesh is indexed
+  uint64_t vertexCount;
+  uint64_t indexCount;
+
+  uint64_t sourceHash;     // content hash of the source and its dependencies
+  uint64_t sourceStamp;    // sizes and write times, checked before hashing
+
+  Bounds bounds;           // object space, over every vertex
+
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+  uint64_t submeshOffset;
+  uint64_t lodOffset;
+  uint64_t fileSize;
+};
+
+/**
+ * Immutable view of a cooked mesh, backed by either a file mapping or the
+ * bytes the cooker just produced. Uploads copy straight out of the streams.
+ */
+class CookedMesh {
+public:
+  /** Returns nullptr if the image is truncated or from another version */
+  static std::unique_ptr<CookedMesh> fromFile(MappedFile file);
+  static std::unique_ptr<CookedMesh> fromBytes(std::vector<std::byte> bytes);
+
+  /** Serializes a mesh into the `.magmamesh` layout */
+  static std::vector<std::byte> serialize(const MeshData &mesh,
+                                          uint64_t sourceHash,
+                                          uint64_t sourceStamp);
+  /** Validates an image without taking ownership of it */
+  static const CookedMeshHeader *validate(const void *data, size_t size);
+
+  const CookedMeshHeader &header() const { return *header_; }
+  const Bounds &bounds() const { return header_->bounds; }
+  /** Raw vertex stream in vertexLayout() */
+  std::span<const std::byte> vertexData() const;
+  uint32_t vertexCount() const { return static_cast<uint32_t>(header_->vertexCount); }
+  VertexLayout vertexLayout() const { return static_cast<VertexLayout>(header_->vertexLayout); }
+  /** Raw index stream, header().indexSize bytes per index */
+  std::span<const std::byte> indexData() const;
+  uint32_t indexCount() const { return static_cast<uint32_t>(header_->indexCount); }
+  std::span<const MeshData::Submesh> submeshes() const;
+  /** Level of detail chain, finest first */
+  std::span<const MeshData::Lod> lods() const;
+
+private:
+  CookedMesh() = default;
+
+  MappedFile file;
+  std::vector<std::byte> bytes;
+  const std::byte *base = nullptr;
+  const CookedMeshHeader *header_ = nullptr;
+};
+
+} // namespace Magma
@@ -1,6 +1,7 @@
 #include "device.hpp"
 #include "external/stb_image.h"
 #include "frame_info.hpp"
+#include "upload_service.hpp"
 #include "window.hpp"
 #include <GLFW/glfw3.h>
 #include <X11/X.h>
@@ -69,7 +70,7 @@ void destroy(VkInstance instance,VkDebugUtilsMessengerEXT debugMessenger,
 
 namespace Magma {
 
-Device::Device(Window &window) {
+Device::Device(Window &window, const DeviceSpecification &spec) {
   createInstance();
   setupDebugMessenger();
 
@@ -78,16 +79,26 @@ Device::Device(Window &window) {
   pickPhysicalDevice();
   vkGetPhysicalDeviceProperties(physicalDevice, &properties);
   createLogicalDevice();
+  allocator_ = std::make_unique<MemoryAllocator>(physicalDevice, device_);
 
   createCommandPool();
   createFence();
 
+  // The upload service allocates its staging ring through Device::get()
   instance_ = this;
+
+  QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+  const uint32_t graphicsFamily = indices.graphicsFamily.value();
+  uploads_ = std::make_unique<UploadService>(
+      device_, transferQueue_, indices.transferFamily.value_or(graphicsFamily),
+      graphicsFamily, spec.stagingRingSize);
 }
 
 Device::~Device() {
+  uploads_.reset();
   vkDestroyCommandPool(device_, commandPool, nullptr);
   vkDestroyFence(device_, fence, nullptr);
+  allocator_.reset();
   vkDestroyDevice(device_, nullptr);
 
   if (enableValidationLayers)
@@ -113,24 +124,21 @@ void Device::populateImGuiInitInfo(ImGui_ImplVulkan_InitInfo *init_info) {
 
 void Device::createImageWithInfo(const VkImageCreateInfo &imageInfo,
                                  VkMemoryPropertyFlags properties,
-                                 VkImage &image, VkDeviceMemory &imageMemory) {
+                                 VkImage &image, Allocation &imageMemory) {
   if (vkCreateImage(device_, &imageInfo, nullptr, &image) != VK_SUCCESS)
     throw std::runtime_error("Failed to create Image!");
 
   VkMemoryRequirements memRequirements;
   vkGetImageMemoryRequirements(device_, image, &memRequirements);
 
-  VkMemoryAllocateInfo allocInfo = {};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex =
-      findMemoryType(memRequirements.memoryTypeBits, properties);
+  // Linear-tiling images are placed with buffers, optimal ones never are
+  MemoryAllocator::ResourceKind kind = imageInfo.tiling == VK_IMAGE_TILING_LINEAR
+      ? MemoryAllocator::ResourceKind::Buffer
+      : MemoryAllocator::ResourceKind::Image;
+  imageMemory = allocator_->allocate(memRequirements, properties, kind);
 
-  if (vkAllocateMemory(device_, &allocInfo, nullptr, &imageMemory) !=
+  if (vkBindImageMemory(device_, image, imageMemory.memory, imageMemory.offset) !=
       VK_SUCCESS)
-    throw std::runtime_error("Failed to allocate image memory!");
-
-  if (vkBindImageMemory(device_, image, imageMemory, 0) != VK_SUCCESS)
     throw std::runtime_error("Failed to bind image memory!");
 }
 
@@ -155,7 +163,7 @@ VkFormat Device::findSupportedFormat(const std::vector<VkFormat> &candidates,
 // Buffer
 void Device::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                           VkMemoryPropertyFlags properties, VkBuffer &buffer,
-                          VkDeviceMemory &bufferMemory) {
+                          Allocation &bufferMemory) {
   VkBufferCreateInfo bufferInfo = {};
   bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
   bufferInfo.size = size;
@@ -168,54 +176,29 @@ void Device::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
   VkMemoryRequirements memRequirements;
   vkGetBufferMemoryRequirements(device_, buffer, &memRequirements);
 
-  VkMemoryAllocateInfo allocInfo = {};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex =
-      findMemoryType(memRequirements.memoryTypeBits, properties);
-
-  if (vkAllocateMemory(device_, &allocInfo, nullptr, &bufferMemory) !=
-      VK_SUCCESS)
-    throw std::runtime_error("Failed to allocate buffer memory!");
+  // Pure staging buffers are short-lived, bump-allocate them
+  AllocationStrategy strategy = usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+      ? AllocationStrategy::Linear
+      : AllocationStrategy::Buddy;
+  bufferMemory = allocator_->allocate(memRequirements, properties,
+                                      MemoryAllocator::ResourceKind::Buffer, strategy);
 
-  vkBindBufferMemory(device_, buffer, bufferMemory, 0);
+  vkBindBufferMemory(device_, buffer, bufferMemory.memory, bufferMemory.offset);
 }
 
 void Device::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer,
                         VkDeviceSize size, VkDeviceSize srcOffset,
                         VkDeviceSize dstOffset) {
-  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
   VkBufferCopy copyRegion = {};
   copyRegion.srcOffset = srcOffset;
   copyRegion.dstOffset = dstOffset;
   copyRegion.size = size;
-  vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-  endSingleTimeCommands(commandBuffer);
+  uploads_->copyBuffer(srcBuffer, dstBuffer, copyRegion);
 }
 
 void Device::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width,
                                uint32_t height) {
-  VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-  VkBufferImageCopy region = {};
-  region.bufferOffset = 0;
-  region.bufferRowLength = 0;
-  region.bufferImageHeight = 0;
-
-  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  region.imageSubresource.mipLevel = 0;
-  region.imageSubresource.baseArrayLayer = 0;
-  region.imageSubresource.layerCount = 1;
-
-  region.imageOffset = {0, 0, 0};
-  region.imageExtent = {width, height, 1};
-
-  vkCmdCopyBufferToImage(commandBuffer, buffer, image,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-  endSingleTimeCommands(commandBuffer);
+  uploads_->copyBufferToImage(buffer, image, width, height);
 }
 
 void Device::copyImageToBuffer(VkCommandBuffer &commandBuffer,
@@ -512,18 +495,20 @@ bool Device::checkDeviceExtensionSupport(VkPhysicalDevice device) {
   return requiredExtensions.empty();
 }
 
-uint32_t Device::findMemoryType(uint32_t typeFilter,
-                                VkMemoryPropertyFlags properties) {
-  VkPhysicalDeviceMemoryProperties memProperties;
-  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+bool Device::isExtensionAvailable(VkPhysicalDevice device, const char *extension) {
+  uint32_t extensionCount;
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                       nullptr);
 
-  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-    if ((typeFilter & (1 << i)) &&
-        (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-      return i;
-  }
+  std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+                                       availableExtensions.data());
 
-  throw std::runtime_error("Failed to find suitable memory type!");
+  for (const auto &available : availableExtensions) {
+    if (strcmp(available.extensionName, extension) == 0)
+      return true;
+  }
+  return false;
 }
 
 // Logical Device
@@ -533,6 +518,8 @@ void Device::createLogicalDevice() {
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
   std::set<uint32_t> uniqueQueueFamilies = {indices.presentFamily.value(),
                                        indices.graphicsFamily.value()};
+  if (indices.transferFamily)
+    uniqueQueueFamilies.insert(indices.transferFamily.value());
 
   float queuePriority = 1.0f;
   for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -554,14 +541,48 @@ void Device::createLogicalDevice() {
   vulkan13Features.dynamicRendering = VK_TRUE;
   vulkan13Features.synchronization2 = VK_TRUE;
 
+  // Upload batches signal a timeline semaphore the frame submit waits on
+  VkPhysicalDeviceVulkan12Features vulkan12Features = {};
+  vulkan12Features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  vulkan12Features.timelineSemaphore = VK_TRUE;
+  vulkan13Features.pNext = &vulkan12Features;
+
+  // gl_DrawID is needed to address instances in multi-draw batches
+  VkPhysicalDeviceVulkan11Features vulkan11Features = {};
+  vulkan11Features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+  vulkan11Features.shaderDrawParameters = VK_TRUE;
+  vulkan12Features.pNext = &vulkan11Features;
+
+  // VK_EXT_multi_draw is optional; renderers fall back to one draw per batch
+  std::vector<const char *> enabledExtensions = deviceExtensions;
+
+  VkPhysicalDeviceMultiDrawFeaturesEXT multiDrawFeatures = {};
+  multiDrawFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT;
+
+  if (isExtensionAvailable(physicalDevice, VK_EXT_MULTI_DRAW_EXTENSION_NAME)) {
+    VkPhysicalDeviceFeatures2 supported = {};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported.pNext = &multiDrawFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &supported);
+
+    if (multiDrawFeatures.multiDraw) {
+      enabledExtensions.push_back(VK_EXT_MULTI_DRAW_EXTENSION_NAME);
+      vulkan11Features.pNext = &multiDrawFeatures;
+      multiDraw_.supported = true;
+    }
+  }
+
   VkDeviceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   createInfo.queueCreateInfoCount =
       static_cast<uint32_t>(queueCreateInfos.size());
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
   createInfo.enabledExtensionCount =
-      static_cast<uint32_t>(deviceExtensions.size());
-  createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+      static_cast<uint32_t>(enabledExtensions.size());
+  createInfo.ppEnabledExtensionNames = enabledExtensions.data();
   createInfo.pEnabledFeatures = &deviceFeatures;
   createInfo.pNext = &vulkan13Features;
 
@@ -569,8 +590,37 @@ void Device::createLogicalDevice() {
       VK_SUCCESS)
     throw std::runtime_error("Failed to create logical device!");
 
+  if (multiDraw_.supported)
+    loadMultiDraw();
+
   vkGetDeviceQueue(device_, indices.graphicsFamily.value(), 0, &graphicsQueue_);
   vkGetDeviceQueue(device_, indices.presentFamily.value(), 0, &presentQueue_);
+
+  if (indices.transferFamily)
+    vkGetDeviceQueue(device_, indices.transferFamily.value(), 0, &transferQueue_);
+  else
+    transferQueue_ = graphicsQueue_;
+}
+
+void Device::loadMultiDraw() {
+  VkPhysicalDeviceMultiDrawPropertiesEXT multiDrawProperties = {};
+  multiDrawProperties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT;
+
+  VkPhysicalDeviceProperties2 properties2 = {};
+  properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties2.pNext = &multiDrawProperties;
+  vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+  multiDraw_.maxDrawCount = multiDrawProperties.maxMultiDrawCount;
+  multiDraw_.cmdDrawMulti = reinterpret_cast<PFN_vkCmdDrawMultiEXT>(
+      vkGetDeviceProcAddr(device_, "vkCmdDrawMultiEXT"));
+  multiDraw_.cmdDrawMultiIndexed = reinterpret_cast<PFN_vkCmdDrawMultiIndexedEXT>(
+      vkGetDeviceProcAddr(device_, "vkCmdDrawMultiIndexedEXT"));
+
+  if (!multiDraw_.cmdDrawMulti || !multiDraw_.cmdDrawMultiIndexed ||
+      multiDraw_.maxDrawCount == 0)
+    multiDraw_ = {};
 }
 
 // Command Pool
@@ -610,18 +660,25 @@ QueueFamilyIndices Device::findQueueFamilies(VkPhysicalDevice device) {
 
   int i = 0;
   for (const auto &queueFamily : queueFamilies) {
-    if (queueFamily.queueCount > 0 &&
-        queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
-      indices.graphicsFamily = i;
+    if (!indices.isComplete()) {
+      if (queueFamily.queueCount > 0 &&
+          queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        indices.graphicsFamily = i;
 
-    VkBool32 presentSupport = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+      VkBool32 presentSupport = false;
+      vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
 
-    if (queueFamily.queueCount > 0 && presentSupport)
-      indices.presentFamily = i;
+      if (queueFamily.queueCount > 0 && presentSupport)
+        indices.presentFamily = i;
+    }
 
-    if (indices.isComplete())
-      break;
+    // Prefer a pure DMA family, fall back to any non-graphics transfer family
+    const VkQueueFlags flags = queueFamily.queueFlags;
+    if (queueFamily.queueCount > 0 && (flags & VK_QUEUE_TRANSFER_BIT) &&
+        !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+      if (!indices.transferFamily || !(flags & VK_QUEUE_COMPUTE_BIT))
+        indices.transferFamily = i;
+    }
 
     i++;
   }
@@ -1,7 +1,10 @@
 #pragma once
 #include "imgui_impl_vulkan.h"
+#include "memory_allocator.hpp"
 #include "queue_family_indices.hpp"
+#include "specifications.hpp"
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <vulkan/vk_platform.h>
 #include <vulkan/vulkan.h>
@@ -10,6 +13,7 @@
 namespace Magma {
 
 class Window;
+class UploadService;
 
 struct SwapchainSupportDetails {
   VkSurfaceCapabilitiesKHR capabilities;
@@ -17,9 +21,17 @@ struct SwapchainSupportDetails {
   std::vector<VkPresentModeKHR> presentModes;
 };
 
+/** Optional VK_EXT_multi_draw support, resolved at device creation */
+struct MultiDrawSupport {
+  bool supported = false;
+  uint32_t maxDrawCount = 0;
+  PFN_vkCmdDrawMultiEXT cmdDrawMulti = nullptr;
+  PFN_vkCmdDrawMultiIndexedEXT cmdDrawMultiIndexed = nullptr;
+};
+
 class Device {
 public:
-  Device(Window &window);
+  Device(Window &window, const DeviceSpecification &spec = {});
   ~Device();
 
   Device(const Device &) = delete;
@@ -30,11 +42,15 @@ public:
   static Device &get() { return *instance_; }
   static VkDeviceSize nonCoherentAtomSize() {
     return get().properties.limits.nonCoherentAtomSize; }
+  static const MultiDrawSupport &multiDraw() { return get().multiDraw_; }
+  static MemoryAllocator &allocator() { return *get().allocator_; }
+  static UploadService &uploads() { return *get().uploads_; }
   VkDevice device() { return device_; }
   VkSurfaceKHR surface() { return surface_; }
   VkCommandPool getCommandPool() { return commandPool; }
   VkQueue graphicsQueue() { return graphicsQueue_; }
   VkQueue presentQueue() { return presentQueue_; }
+  VkQueue transferQueue() { return transferQueue_; }
 
   void populateImGuiInitInfo(ImGui_ImplVulkan_InitInfo *init_info);
 
@@ -45,7 +61,7 @@ public:
 
   void createImageWithInfo(const VkImageCreateInfo &imageInfo,
                            VkMemoryPropertyFlags properties, VkImage &image,
-                           VkDeviceMemory &imageMemory);
+                           Allocation &imageMemory);
   void generateImage(const char *filename, VkImageView &imageView,
                      VkSampler &sampler);
 
@@ -55,7 +71,10 @@ public:
 
   void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                     VkMemoryPropertyFlags properties, VkBuffer &buffer,
-                    VkDeviceMemory &bufferMemory);
+                    Allocation &bufferMemory);
+  static void freeMemory(const Allocation &allocation) {
+    allocator().free(allocation); }
+  /** Queued on the UploadService; the source has to outlive the upload batch */
   void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size,
                   VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
   void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width,
@@ -109,18 +128,23 @@ private:
   VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
   VkPhysicalDeviceProperties properties;
   const std::vector<const char *> deviceExtensions = {
-      VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_EXT_MULTI_DRAW_EXTENSION_NAME,
+      VK_KHR_SWAPCHAIN_EXTENSION_NAME,
       VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME};
   void pickPhysicalDevice();
   bool isDeviceSuitable(VkPhysicalDevice device);
   SwapchainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
   bool checkDeviceExtensionSupport(VkPhysicalDevice device);
-  uint32_t findMemoryType(uint32_t typeFilter,
-                          VkMemoryPropertyFlags properties);
+  bool isExtensionAvailable(VkPhysicalDevice device, const char *extension);
+
+  MultiDrawSupport multiDraw_{};
+  void loadMultiDraw();
 
   VkDevice device_;
+  std::unique_ptr<MemoryAllocator> allocator_;
+  std::unique_ptr<UploadService> uploads_;
   VkQueue graphicsQueue_;
   VkQueue presentQueue_;
+  VkQueue transferQueue_;
   void createLogicalDevice();
 
   VkCommandPool commandPool;
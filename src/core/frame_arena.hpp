@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Magma {
+
+/**
+ * Fixed-capacity array whose storage lives in a FrameArena.
+ * Valid until the owning arena is reset; never frees or reallocates.
+ */
+template <typename T>
+class ArenaArray {
+public:
+  ArenaArray() = default;
+  ArenaArray(T *data, uint32_t capacity) : data_{data}, capacity_{capacity} {}
+
+  void push_back(const T &value) {
+    assert(size_ < capacity_ && "ArenaArray capacity exceeded!");
+    data_[size_++] = value;
+  }
+  void clear() { size_ = 0; }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
+  uint32_t size() const { return size_; }
+  uint32_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  T &operator[](uint32_t i) { return data_[i]; }
+  const T &operator[](uint32_t i) const { return data_[i]; }
+
+  T *begin() { return data_; }
+  T *end() { return data_ + size_; }
+  const T *begin() const { return data_; }
+  const T *end() const { return data_ + size_; }
+
+private:
+  T *data_ = nullptr;
+  uint32_t size_ = 0;
+  uint32_t capacity_ = 0;
+};
+
+/**
+ * Linear allocator for transient per-frame CPU data such as draw lists.
+ * Allocation is a pointer bump; everything is released at once by reset().
+ * When a frame overflows the current block, extra blocks are chained and
+ * merged into a single larger block on the next reset, so the steady-state
+ * frame loop performs no heap allocations.
+ */
+class FrameArena {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+  explicit FrameArena(size_t capacity = DEFAULT_CAPACITY) { addBlock(capacity); }
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  void *allocate(size_t size, size_t alignment) {
+    Block &block = blocks.back();
+    size_t offset = alignUp(block.used, alignment);
+    if (offset + size > block.capacity) {
+      addBlock(std::max(block.capacity * 2, size + alignment));
+      return allocate(size, alignment);
+    }
+    block.used = offset + size;
+    return block.memory.get() + offset;
+  }
+
+  template <typename T>
+  ArenaArray<T> allocArray(uint32_t capacity) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "FrameArena never runs destructors");
+    if (capacity == 0) return {};
+    void *memory = allocate(sizeof(T) * capacity, alignof(T));
+    return ArenaArray<T>(static_cast<T *>(memory), capacity);
+  }
+
+  void reset() {
+    if (blocks.size() > 1) {
+      size_t total = 0;
+      for (auto &block : blocks) total += block.capacity;
+      blocks.clear();
+      addBlock(total);
+    }
+    blocks.back().used = 0;
+  }
+
+private:
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    size_t capacity = 0;
+    size_t used = 0;
+  };
+  std::vector<Block> blocks;
+
+  void addBlock(size_t capacity) {
+    blocks.push_back({std::make_unique<std::byte[]>(capacity), capacity, 0});
+  }
+
+  static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+  }
+};
+
+} // namespace Magma
@@ -0,0 +1,188 @@
+#include "frustum.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <immintrin.h>
+  #define MAGMA_CULL_SSE 1
+#endif
+
+// AVX2 is compiled in for GCC and Clang even when the build doesn't target
+// it, and only taken when the CPU reports support
+#if defined(MAGMA_CULL_SSE) && (defined(__AVX2__) || defined(__GNUC__))
+  #define MAGMA_CULL_AVX2 1
+  #if defined(__AVX2__)
+    #define MAGMA_AVX2_TARGET
+  #else
+    #define MAGMA_AVX2_TARGET __attribute__((target("avx2")))
+  #endif
+#endif
+
+namespace Magma {
+
+namespace {
+
+/** Plane normals and their absolute values, loaded once per cull call */
+struct PlaneSet {
+  float nx[6], ny[6], nz[6], d[6];
+  float ax[6], ay[6], az[6];
+
+  explicit PlaneSet(const Frustum &frustum) {
+    for (size_t p = 0; p < 6; ++p) {
+      const glm::vec4 &plane = frustum.planes[p];
+      nx[p] = plane.x; ny[p] = plane.y; nz[p] = plane.z; d[p] = plane.w;
+      ax[p] = std::abs(plane.x); ay[p] = std::abs(plane.y); az[p] = std::abs(plane.z);
+    }
+  }
+};
+
+bool visibleScalar(const PlaneSet &planes, const CullBounds &b, uint32_t i) {
+  for (size_t p = 0; p < 6; ++p) {
+    const float distance = planes.nx[p] * b.centerX[i] + planes.ny[p] * b.centerY[i] +
+                           planes.nz[p] * b.centerZ[i] + planes.d[p];
+    const float boxRadius = planes.ax[p] * b.extentX[i] + planes.ay[p] * b.extentY[i] +
+                            planes.az[p] * b.extentZ[i];
+    if (distance + std::min(boxRadius, b.radius[i]) < 0.f) return false;
+  }
+  return true;
+}
+
+#if defined(MAGMA_CULL_SSE)
+/** Returns one bit per visible lane of the 4 starting at i */
+uint32_t visibleSse(const PlaneSet &planes, const CullBounds &b, uint32_t i) {
+  const __m128 cx = _mm_loadu_ps(b.centerX + i);
+  const __m128 cy = _mm_loadu_ps(b.centerY + i);
+  const __m128 cz = _mm_loadu_ps(b.centerZ + i);
+  const __m128 ex = _mm_loadu_ps(b.extentX + i);
+  const __m128 ey = _mm_loadu_ps(b.extentY + i);
+  const __m128 ez = _mm_loadu_ps(b.extentZ + i);
+  const __m128 radius = _mm_loadu_ps(b.radius + i);
+
+  __m128 outside = _mm_setzero_ps();
+  for (size_t p = 0; p < 6; ++p) {
+    __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), cx),
+                                 _mm_mul_ps(_mm_set1_ps(planes.ny[p]), cy));
+    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.nz[p]), cz));
+    distance = _mm_add_ps(distance, _mm_set1_ps(planes.d[p]));
+
+    __m128 boxRadius = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.ax[p]), ex),
+                                  _mm_mul_ps(_mm_set1_ps(planes.ay[p]), ey));
+    boxRadius = _mm_add_ps(boxRadius, _mm_mul_ps(_mm_set1_ps(planes.az[p]), ez));
+
+    const __m128 reach = _mm_add_ps(distance, _mm_min_ps(boxRadius, radius));
+    outside = _mm_or_ps(outside, _mm_cmplt_ps(reach, _mm_setzero_ps()));
+  }
+  return ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xFu;
+}
+#endif
+
+#if defined(MAGMA_CULL_AVX2)
+/** Returns one bit per visible lane of the 8 starting at i */
+MAGMA_AVX2_TARGET
+uint32_t visibleAvx2(const PlaneSet &planes, const CullBounds &b, uint32_t i) {
+  const __m256 cx = _mm256_loadu_ps(b.centerX + i);
+  const __m256 cy = _mm256_loadu_ps(b.centerY + i);
+  const __m256 cz = _mm256_loadu_ps(b.centerZ + i);
+  const __m256 ex = _mm256_loadu_ps(b.extentX + i);
+  const __m256 ey = _mm256_loadu_ps(b.extentY + i);
+  const __m256 ez = _mm256_loadu_ps(b.extentZ + i);
+  const __m256 radius = _mm256_loadu_ps(b.radius + i);
+
+  __m256 outside = _mm256_setzero_ps();
+  for (size_t p = 0; p < 6; ++p) {
+    __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), cx),
+                                    _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), cy));
+    distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), cz));
+    distance = _mm256_add_ps(distance, _mm256_set1_ps(planes.d[p]));
+
+    __m256 boxRadius = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.ax[p]), ex),
+                                     _mm256_mul_ps(_mm256_set1_ps(planes.ay[p]), ey));
+    boxRadius = _mm256_add_ps(boxRadius, _mm256_mul_ps(_mm256_set1_ps(planes.az[p]), ez));
+
+    const __m256 reach = _mm256_add_ps(distance, _mm256_min_ps(boxRadius, radius));
+    outside = _mm256_or_ps(outside, _mm256_cmp_ps(reach, _mm256_setzero_ps(), _CMP_LT_OQ));
+  }
+  return ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFu;
+}
+
+bool hasAvx2() {
+  #if defined(__AVX2__)
+    return true;
+  #else
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+  #endif
+}
+#endif
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+Frustum Frustum::fromMatrix(const glm::mat4 &projView) {
+  // Gribb-Hartmann: planes are sums of the matrix rows
+  auto row = [&](int r) {
+    return glm::vec4{projView[0][r], projView[1][r], projView[2][r], projView[3][r]};
+  };
+
+  Frustum frustum;
+  frustum.planes = {
+      row(3) + row(0), row(3) - row(0), // left, right
+      row(3) + row(1), row(3) - row(1), // bottom, top
+      row(2),          row(3) - row(2), // near (depth 0), far
+  };
+  for (glm::vec4 &plane : frustum.planes) {
+    const float length = glm::length(glm::vec3{plane});
+    if (length > 0.f) plane /= length;
+  }
+  return frustum;
+}
+
+bool Frustum::intersects(const glm::vec3 &center, const glm::vec3 &extent,
+                         float radius) const {
+  for (const glm::vec4 &plane : planes) {
+    const glm::vec3 normal{plane};
+    const float boxRadius = glm::dot(glm::abs(normal), extent);
+    if (glm::dot(normal, center) + plane.w + std::min(boxRadius, radius) < 0.f)
+      return false;
+  }
+  return true;
+}
+
+void FrustumCuller::cull(const Frustum &frustum, const CullBounds &bounds, uint32_t count,
+                         uint32_t viewBit, uint32_t *masks) {
+  const PlaneSet planes{frustum};
+  uint32_t i = 0;
+
+  auto markLanes = [&](uint32_t visible, uint32_t lanes) {
+    for (uint32_t lane = 0; lane < lanes; ++lane)
+      if (visible & (1u << lane)) masks[i + lane] |= viewBit;
+  };
+
+  #if defined(MAGMA_CULL_AVX2)
+    if (hasAvx2())
+      for (; i + 8 <= count; i += 8)
+        markLanes(visibleAvx2(planes, bounds, i), 8);
+  #endif
+  #if defined(MAGMA_CULL_SSE)
+    for (; i + 4 <= count; i += 4)
+      markLanes(visibleSse(planes, bounds, i), 4);
+  #endif
+  for (; i < count; ++i)
+    if (visibleScalar(planes, bounds, i)) masks[i] |= viewBit;
+}
+
+const char *FrustumCuller::simdPath() {
+  #if defined(MAGMA_CULL_AVX2)
+    if (hasAvx2()) return "AVX2";
+  #endif
+  #if defined(MAGMA_CULL_SSE)
+    return "SSE";
+  #else
+    return "Scalar";
+  #endif
+}
+
+} // namespace Magma
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Magma {
+
+/** Six inward facing planes (xyz normal, w distance) of a view volume */
+struct Frustum {
+  std::array<glm::vec4, 6> planes{};
+
+  /** Extracts the planes of a projection * view matrix with 0..1 depth */
+  static Frustum fromMatrix(const glm::mat4 &projView);
+
+  /** Box (center, half extents) test, tightened by a sphere on the same center */
+  bool intersects(const glm::vec3 &center, const glm::vec3 &extent, float radius) const;
+};
+
+/**
+ * World space bounds in SoA layout, one lane per object: box center and
+ * half extents plus the radius of a sphere around the same center.
+ */
+struct CullBounds {
+  float *centerX = nullptr, *centerY = nullptr, *centerZ = nullptr;
+  float *extentX = nullptr, *extentY = nullptr, *extentZ = nullptr;
+  float *radius = nullptr;
+};
+
+/**
+ * Tests bounds against a frustum 8 lanes at a time with AVX2 when the CPU
+ * supports it, 4 at a time with SSE, and one at a time otherwise.
+ */
+class FrustumCuller {
+public:
+  /** Sets viewBit in masks[i] for every visible object i < count */
+  static void cull(const Frustum &frustum, const CullBounds &bounds, uint32_t count,
+                   uint32_t viewBit, uint32_t *masks);
+
+  /** Name of the path cull() takes on this CPU */
+  static const char *simdPath();
+};
+
+} // namespace Magma
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Magma {
+
+/**
+ * Fast non-cryptographic 64-bit hash for content keys (cooked asset caches).
+ * Consumes eight bytes per step so hashing stays I/O bound on large files.
+ */
+inline uint64_t hashMix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+inline uint64_t hashBytes(const void *data, size_t size,
+                          uint64_t seed = 0x9e3779b97f4a7c15ull) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  uint64_t hash = seed ^ (size * 0x87c37b91114253d5ull);
+
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    hash = (hash ^ hashMix(word)) * 0x9e3779b97f4a7c15ull;
+  }
+
+  uint64_t tail = 0;
+  std::memcpy(&tail, bytes + i, size - i);
+  hash ^= hashMix(tail ^ (size - i));
+  return hashMix(hash);
+}
+
+inline uint64_t hashCombine(uint64_t hash, uint64_t value) {
+  return hashMix(hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2)));
+}
+
+} // namespace Magma
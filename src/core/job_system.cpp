@@ -0,0 +1,285 @@
+#include "job_system.hpp"
+
+namespace Magma {
+
+// ----------------------------------------------------------------------------
+// WorkStealingDeque
+// ----------------------------------------------------------------------------
+
+// Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models",
+// with the fences folded into the neighbouring accesses
+bool WorkStealingDeque::push(Job *job) {
+  const int64_t b = bottom.load(std::memory_order_relaxed);
+  const int64_t t = top.load(std::memory_order_acquire);
+  if (b - t >= CAPACITY) return false;
+  buffer[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+  bottom.store(b + 1, std::memory_order_release);
+  return true;
+}
+
+Job *WorkStealingDeque::pop() {
+  const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+  bottom.store(b, std::memory_order_seq_cst);
+  int64_t t = top.load(std::memory_order_seq_cst);
+  if (t > b) {
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  Job *job = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+  if (t == b) {
+    // Last job, thieves may be racing for it
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+      job = nullptr;
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+Job *WorkStealingDeque::steal() {
+  int64_t t = top.load(std::memory_order_seq_cst);
+  const int64_t b = bottom.load(std::memory_order_seq_cst);
+  if (t >= b) return nullptr;
+
+  Job *job = buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+  if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                   std::memory_order_relaxed))
+    return nullptr;
+  return job;
+}
+
+// ----------------------------------------------------------------------------
+// JobSystem
+// ----------------------------------------------------------------------------
+
+JobSystem::JobSystem(const JobSystemSpecification &spec) {
+  const uint32_t workerCount = spec.workerCount ? spec.workerCount : defaultWorkerCount();
+  for (uint32_t i = 0; i <= workerCount; ++i)
+    deques.push_back(std::make_unique<WorkStealingDeque>());
+  jobCaches = std::make_unique<JobCache[]>(deques.size());
+
+  // The constructing thread is the main thread
+  threadIndex = 0;
+  instance_ = this;
+
+  workers.reserve(workerCount);
+  for (uint32_t i = 1; i <= workerCount; ++i)
+    workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+JobSystem::~JobSystem() {
+  stopping.store(true);
+  workSignal.fetch_add(1);
+  workSignal.notify_all();
+  workers.clear();
+
+  // Jobs nobody got to are dropped without running
+  while (Job *job = findJob()) {
+    job->call(job->storage, false);
+    freeJob(job);
+  }
+  threadIndex = NOT_A_WORKER;
+  instance_ = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void JobSystem::wait(const JobCounter &counter) {
+  while (!counter.isDone()) {
+    if (runOne()) continue;
+
+    // Nothing left to help with; sleep until a counter finishes or main
+    // thread work shows up, checking again after reading the signal
+    const uint32_t seen = waitSignal.load(std::memory_order_acquire);
+    if (counter.isDone() || runOne()) continue;
+    waitSignal.wait(seen, std::memory_order_acquire);
+  }
+}
+
+bool JobSystem::runOne() {
+  Job *job = findJob();
+  if (!job) return false;
+  execute(job);
+  return true;
+}
+
+uint32_t JobSystem::defaultWorkerCount() {
+  // Leave a core for the main thread
+  const uint32_t cores = std::thread::hardware_concurrency();
+  return std::max(1u, cores > 1 ? cores - 1 : 1u);
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+void JobSystem::JobQueue::push(Job *job) {
+  job->next = nullptr;
+  if (tail) tail->next = job;
+  else head = job;
+  tail = job;
+}
+
+Job *JobSystem::JobQueue::pop() {
+  Job *job = head;
+  if (!job) return nullptr;
+  head = job->next;
+  if (!head) tail = nullptr;
+  return job;
+}
+
+Job *JobSystem::allocateJob() {
+  const uint32_t self = threadIndex;
+  if (self >= deques.size()) {
+    std::lock_guard lock(poolMutex);
+    return takeFreeJobs(1);
+  }
+
+  JobCache &cache = jobCaches[self];
+  if (!cache.head) {
+    std::lock_guard lock(poolMutex);
+    cache.head = takeFreeJobs(JOB_BATCH);
+    cache.count = JOB_BATCH;
+  }
+  Job *job = cache.head;
+  cache.head = job->next;
+  cache.count--;
+  return job;
+}
+
+void JobSystem::freeJob(Job *job) {
+  const uint32_t self = threadIndex;
+  if (self >= deques.size()) {
+    std::lock_guard lock(poolMutex);
+    job->next = freeJobs;
+    freeJobs = job;
+    return;
+  }
+
+  JobCache &cache = jobCaches[self];
+  job->next = cache.head;
+  cache.head = job;
+  if (++cache.count < 2 * JOB_BATCH) return;
+
+  // Threads mostly freeing jobs others submitted hand a batch back
+  Job *last = cache.head;
+  for (uint32_t i = 1; i < JOB_BATCH; ++i) last = last->next;
+  std::lock_guard lock(poolMutex);
+  Job *batch = cache.head;
+  cache.head = last->next;
+  cache.count -= JOB_BATCH;
+  last->next = freeJobs;
+  freeJobs = batch;
+}
+
+Job *JobSystem::takeFreeJobs(uint32_t count) {
+  Job *head = nullptr;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (!freeJobs) {
+      auto &block = jobBlocks.emplace_back(std::make_unique<Job[]>(JOB_BATCH));
+      for (uint32_t j = 0; j < JOB_BATCH; ++j) {
+        block[j].next = freeJobs;
+        freeJobs = &block[j];
+      }
+    }
+    Job *job = freeJobs;
+    freeJobs = job->next;
+    job->next = head;
+    head = job;
+  }
+  return head;
+}
+
+void JobSystem::push(Job *job) {
+  if (threadIndex >= deques.size() || !deques[threadIndex]->push(job)) {
+    std::lock_guard lock(sharedMutex);
+    sharedJobs.push(job);
+    sharedCount.fetch_add(1, std::memory_order_release);
+  }
+  workSignal.fetch_add(1, std::memory_order_release);
+  workSignal.notify_one();
+}
+
+void JobSystem::pushMain(Job *job) {
+  {
+    std::lock_guard lock(sharedMutex);
+    mainJobs.push(job);
+    mainCount.fetch_add(1, std::memory_order_release);
+  }
+  waitSignal.fetch_add(1, std::memory_order_release);
+  waitSignal.notify_all();
+}
+
+Job *JobSystem::findJob() {
+  const uint32_t self = threadIndex;
+
+  // Main thread only work first, then our own newest job
+  if (self == 0 && mainCount.load(std::memory_order_acquire) > 0) {
+    std::lock_guard lock(sharedMutex);
+    if (Job *job = mainJobs.pop()) {
+      mainCount.fetch_sub(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+  if (self < deques.size())
+    if (Job *job = deques[self]->pop()) return job;
+
+  if (sharedCount.load(std::memory_order_acquire) > 0) {
+    std::lock_guard lock(sharedMutex);
+    if (Job *job = sharedJobs.pop()) {
+      sharedCount.fetch_sub(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+
+  // Steal the oldest job of another thread, starting at a different victim
+  // on every thread so thieves spread out
+  thread_local uint32_t seed = static_cast<uint32_t>(
+      std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  const uint32_t count = static_cast<uint32_t>(deques.size());
+  for (uint32_t i = 0, victim = seed % count; i < count; ++i, victim = (victim + 1) % count) {
+    if (victim == self) continue;
+    if (Job *job = deques[victim]->steal()) return job;
+  }
+  return nullptr;
+}
+
+void JobSystem::execute(Job *job) {
+  job->call(job->storage, true);
+  JobCounter *counter = job->counter;
+  freeJob(job);
+
+  // Past the decrement the counter may already be gone, so only our own
+  // signal is touched
+  if (counter && counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    waitSignal.fetch_add(1, std::memory_order_release);
+    waitSignal.notify_all();
+  }
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+  threadIndex = index;
+  while (!stopping.load(std::memory_order_acquire)) {
+    if (runOne()) continue;
+
+    // Spin briefly, since frame work tends to come in bursts
+    bool found = false;
+    for (uint32_t spin = 0; spin < 64 && !found; ++spin) {
+      std::this_thread::yield();
+      found = runOne();
+    }
+    if (found) continue;
+
+    const uint32_t seen = workSignal.load(std::memory_order_acquire);
+    if (stopping.load(std::memory_order_acquire) || runOne()) continue;
+    workSignal.wait(seen, std::memory_order_acquire);
+  }
+}
+
+} // namespace Magma
@@ -0,0 +1,220 @@
+#pragma once
+#include "specifications.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Magma {
+
+class JobCounter;
+
+/**
+ * One queued job: its callable lives in place, so submitting and running it
+ * doesn't allocate. Jobs come from the JobSystem's pool and go back to it.
+ */
+struct alignas(64) Job {
+  static constexpr size_t STORAGE_SIZE = 40;
+
+  alignas(std::max_align_t) std::byte storage[STORAGE_SIZE];
+  // Runs the callable when asked to, then destroys it
+  void (*call)(void *storage, bool run) = nullptr;
+  JobCounter *counter = nullptr;
+  Job *next = nullptr; // in a free list or intrusive queue
+};
+
+/**
+ * Fence over a group of jobs: counts the jobs submitted with it that have
+ * not finished yet. Jobs may submit more jobs on the same counter, which
+ * keeps it from reaching zero before they are done too.
+ */
+class JobCounter {
+public:
+  JobCounter() = default;
+  JobCounter(const JobCounter &) = delete;
+  JobCounter &operator=(const JobCounter &) = delete;
+
+  bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+  friend class JobSystem;
+  std::atomic<uint32_t> pending{0};
+};
+
+/**
+ * Chase-Lev work stealing deque of fixed capacity. The owning thread pushes
+ * and pops at the bottom, any other thread steals from the top.
+ */
+class WorkStealingDeque {
+public:
+  static constexpr int64_t CAPACITY = 4096;
+
+  /** Owner only; false when full */
+  bool push(Job *job);
+  /** Owner only; newest job first */
+  Job *pop();
+  /** Any thread; oldest job first, nullptr when empty or on a lost race */
+  Job *steal();
+
+private:
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::atomic<Job *> buffer[CAPACITY] = {};
+};
+
+/**
+ * Engine wide work stealing job system. Every worker and the main thread
+ * own a deque they push their jobs to; idle workers steal from the others.
+ * Threads waiting on a JobCounter run queued jobs meanwhile instead of
+ * blocking, so jobs may wait on jobs they submitted. Jobs submitted to the
+ * main thread only run there, from wait() or runOne(), for work that must
+ * stay on it.
+ * Jobs must not throw, except inside parallelFor, which rethrows.
+ * @note Owned by the Engine; reachable through JobSystem::get()
+ */
+class JobSystem {
+public:
+  explicit JobSystem(const JobSystemSpecification &spec = {});
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  static JobSystem &get() { return *instance_; }
+
+  /**
+   * Queues a job; counter, when given, counts it until it has finished.
+   * The callable is stored in the job itself and must fit Job::STORAGE_SIZE.
+   */
+  template <typename F>
+  void submit(F &&task, JobCounter *counter = nullptr) { push(makeJob(std::forward<F>(task), counter)); }
+  /** Queues a job only the main thread runs, the next time it waits */
+  template <typename F>
+  void submitToMain(F &&task, JobCounter *counter = nullptr) { pushMain(makeJob(std::forward<F>(task), counter)); }
+  /** Runs queued jobs on the calling thread until counter reaches zero */
+  void wait(const JobCounter &counter);
+  /** Runs one queued job on the calling thread, false if none was found */
+  bool runOne();
+
+  /**
+   * Calls body(begin, end) over [0, count) in ranges of at most grain
+   * items, spread over the workers and the calling thread. Returns when
+   * every range is done and rethrows the first exception thrown.
+   */
+  template <typename F>
+  void parallelFor(uint32_t count, uint32_t grain, F &&body);
+
+  uint32_t workerCount() const { return static_cast<uint32_t>(workers.size()); }
+  static uint32_t defaultWorkerCount();
+
+private:
+  inline static JobSystem *instance_ = nullptr;
+  static constexpr uint32_t NOT_A_WORKER = UINT32_MAX;
+  // Deque index of the calling thread; the main thread owns deque 0
+  inline static thread_local uint32_t threadIndex = NOT_A_WORKER;
+
+  std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+  std::vector<std::jthread> workers;
+  std::atomic<bool> stopping{false};
+
+  // Intrusive FIFO of jobs linked through Job::next
+  struct JobQueue {
+    Job *head = nullptr;
+    Job *tail = nullptr;
+    void push(Job *job);
+    Job *pop();
+  };
+
+  // Jobs from threads without a deque, or from full deques
+  std::mutex sharedMutex;
+  JobQueue sharedJobs;
+  JobQueue mainJobs;
+  std::atomic<uint32_t> sharedCount{0};
+  std::atomic<uint32_t> mainCount{0};
+
+  // Job pool: threads with a deque keep a private free list and trade
+  // batches with the shared one, so steady state submits don't allocate
+  static constexpr uint32_t JOB_BATCH = 64;
+  struct alignas(64) JobCache {
+    Job *head = nullptr;
+    uint32_t count = 0;
+  };
+  std::unique_ptr<JobCache[]> jobCaches;
+  std::mutex poolMutex;
+  Job *freeJobs = nullptr;
+  std::vector<std::unique_ptr<Job[]>> jobBlocks;
+
+  // Bumped on new work to wake sleeping workers, and on finished counters
+  // or main thread jobs to wake waiting threads
+  std::atomic<uint32_t> workSignal{0};
+  std::atomic<uint32_t> waitSignal{0};
+
+  template <typename F>
+  Job *makeJob(F &&task, JobCounter *counter);
+  Job *allocateJob();
+  void freeJob(Job *job);
+  /** Takes up to count jobs off the shared free list, allocating when empty */
+  Job *takeFreeJobs(uint32_t count);
+
+  void push(Job *job);
+  void pushMain(Job *job);
+  Job *findJob();
+  void execute(Job *job);
+  void workerLoop(uint32_t index);
+};
+
+template <typename F>
+Job *JobSystem::makeJob(F &&task, JobCounter *counter) {
+  using Task = std::decay_t<F>;
+  static_assert(sizeof(Task) <= Job::STORAGE_SIZE, "Job callable doesn't fit in Job::STORAGE_SIZE");
+  static_assert(alignof(Task) <= alignof(std::max_align_t), "Job callable is over-aligned");
+
+  Job *job = allocateJob();
+  ::new (static_cast<void *>(job->storage)) Task(std::forward<F>(task));
+  job->call = [](void *storage, bool run) {
+    Task &callable = *std::launder(static_cast<Task *>(storage));
+    if (run) callable();
+    callable.~Task();
+  };
+  job->counter = counter;
+  if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+  return job;
+}
+
+template <typename F>
+void JobSystem::parallelFor(uint32_t count, uint32_t grain, F &&body) {
+  if (count == 0) return;
+  grain = std::max(grain, 1u);
+
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto runRange = [&](uint32_t begin, uint32_t end) {
+    try {
+      body(begin, end);
+    } catch (...) {
+      std::lock_guard lock(errorMutex);
+      if (!error) error = std::current_exception();
+    }
+  };
+
+  // The caller takes the first range itself
+  JobCounter counter;
+  for (uint32_t begin = grain; begin < count; begin += grain) {
+    const uint32_t end = std::min(count, begin + grain);
+    submit([&runRange, begin, end] { runRange(begin, end); }, &counter);
+  }
+  runRange(0, std::min(count, grain));
+  wait(counter);
+
+  if (error) std::rethrow_exception(error);
+}
+
+} // namespace Magma
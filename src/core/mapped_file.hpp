@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Magma {
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The pages are only faulted in when touched, so copying out of the mapping
+ * reads straight from the page cache without an intermediate buffer.
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  /** False if the file couldn't be opened or is empty */
+  bool valid() const { return data_ != nullptr; }
+  const void *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+
+  void unmap();
+};
+
+} // namespace Magma
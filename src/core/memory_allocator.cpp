@@ -0,0 +1,286 @@
+#include "memory_allocator.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+namespace {
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+MemoryAllocator::MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device)
+    : device{device} {
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  nonCoherentAtomSize = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+}
+
+MemoryAllocator::~MemoryAllocator() {
+  for (auto &pool : pools) {
+    for (auto &block : pool.blocks) {
+      if (block) freeMemory(block->memory, block->mapped != nullptr);
+    }
+  }
+  pools.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+Allocation MemoryAllocator::allocate(const VkMemoryRequirements &requirements,
+                                     VkMemoryPropertyFlags properties,
+                                     ResourceKind kind, AllocationStrategy strategy) {
+  std::lock_guard lock(mutex);
+
+  const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+  const uint32_t poolIndex = findPool(memoryType, kind, strategy);
+  Pool &pool = pools[poolIndex];
+
+  // Non-coherent memory is flushed in atom units, keep neighbours apart
+  VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+  if (pool.hostVisible)
+    alignment = std::max(alignment, nonCoherentAtomSize);
+
+  Allocation allocation{};
+  allocation.pool = poolIndex;
+  allocation.size = requirements.size;
+
+  if (requirements.size > pool.blockSize / 2) {
+    allocation.memory = allocateMemory(memoryType, requirements.size, &allocation.mapped);
+    allocation.dedicated = true;
+    return allocation;
+  }
+
+  VkDeviceSize size = requirements.size;
+  if (strategy == AllocationStrategy::Buddy)
+    size = std::bit_ceil(std::max({size, alignment, MIN_NODE_SIZE}));
+
+  auto tryBlock = [&](uint32_t blockIndex) {
+    Block &block = *pool.blocks[blockIndex];
+    bool ok = strategy == AllocationStrategy::Buddy
+                  ? allocateBuddy(pool, block, size, allocation)
+                  : allocateLinear(pool, block, size, alignment, allocation);
+    if (!ok) return false;
+
+    allocation.memory = block.memory;
+    allocation.block = blockIndex;
+    allocation.mapped = block.mapped
+        ? static_cast<char *>(block.mapped) + allocation.offset : nullptr;
+    return true;
+  };
+
+  for (uint32_t i = 0; i < pool.blocks.size(); ++i) {
+    if (pool.blocks[i] && tryBlock(i))
+      return allocation;
+  }
+
+  addBlock(pool);
+  for (uint32_t i = 0; i < pool.blocks.size(); ++i) {
+    if (pool.blocks[i] && tryBlock(i))
+      return allocation;
+  }
+
+  throw std::runtime_error("MemoryAllocator: failed to suballocate from a new block!");
+}
+
+void MemoryAllocator::free(const Allocation &allocation) {
+  if (!allocation.valid()) return;
+
+  std::lock_guard lock(mutex);
+
+  if (allocation.dedicated) {
+    freeMemory(allocation.memory, allocation.mapped != nullptr);
+    return;
+  }
+
+  Pool &pool = pools[allocation.pool];
+  auto &block = pool.blocks[allocation.block];
+
+  bool blockEmpty = false;
+  if (pool.strategy == AllocationStrategy::Buddy) {
+    freeBuddy(pool, *block, allocation.offset, allocation.order);
+    blockEmpty = block->freeNodes[pool.maxOrder].count(0) > 0;
+  } else {
+    if (--block->liveCount == 0) block->head = 0;
+    blockEmpty = block->liveCount == 0;
+  }
+
+  // Keep one block per pool around to avoid churn on the driver
+  uint32_t liveBlocks = 0;
+  for (auto &b : pool.blocks) liveBlocks += b != nullptr;
+  if (blockEmpty && liveBlocks > 1) {
+    freeMemory(block->memory, block->mapped != nullptr);
+    block.reset();
+  }
+}
+
+void MemoryAllocator::flush(const Allocation &allocation, VkDeviceSize size,
+                            VkDeviceSize offset) {
+  if (!allocation.valid()) return;
+
+  std::lock_guard lock(mutex);
+  const Pool &pool = pools[allocation.pool];
+  const VkMemoryPropertyFlags flags =
+      memoryProperties.memoryTypes[pool.memoryType].propertyFlags;
+  if (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) return;
+
+  if (size == VK_WHOLE_SIZE) size = allocation.size - offset;
+
+  const VkDeviceSize memorySize = allocation.dedicated ? allocation.size : pool.blockSize;
+  const VkDeviceSize begin = allocation.offset + offset;
+  const VkDeviceSize alignedBegin = (begin / nonCoherentAtomSize) * nonCoherentAtomSize;
+  const VkDeviceSize alignedEnd =
+      std::min(alignUp(begin + size, nonCoherentAtomSize), memorySize);
+
+  VkMappedMemoryRange range{};
+  range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+  range.memory = allocation.memory;
+  range.offset = alignedBegin;
+  range.size = alignedEnd - alignedBegin;
+  vkFlushMappedMemoryRanges(device, 1, &range);
+}
+
+uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter,
+                                         VkMemoryPropertyFlags properties) const {
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+    if ((typeFilter & (1 << i)) &&
+        (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+      return i;
+  }
+
+  throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+uint32_t MemoryAllocator::findPool(uint32_t memoryType, ResourceKind kind,
+                                   AllocationStrategy strategy) {
+  for (uint32_t i = 0; i < pools.size(); ++i) {
+    const Pool &pool = pools[i];
+    if (pool.memoryType == memoryType && pool.kind == kind && pool.strategy == strategy)
+      return i;
+  }
+
+  const VkMemoryType &type = memoryProperties.memoryTypes[memoryType];
+  const VkDeviceSize heapSize = memoryProperties.memoryHeaps[type.heapIndex].size;
+
+  // Small heaps (e.g. BAR memory) get smaller blocks
+  VkDeviceSize blockSize = MAX_BLOCK_SIZE;
+  while (blockSize > heapSize / 8 && blockSize > 1024 * 1024)
+    blockSize /= 2;
+
+  Pool pool{};
+  pool.memoryType = memoryType;
+  pool.kind = kind;
+  pool.strategy = strategy;
+  pool.blockSize = blockSize;
+  pool.maxOrder = static_cast<uint8_t>(std::countr_zero(blockSize / MIN_NODE_SIZE));
+  pool.hostVisible = type.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  pools.push_back(std::move(pool));
+  return static_cast<uint32_t>(pools.size() - 1);
+}
+
+MemoryAllocator::Block &MemoryAllocator::addBlock(Pool &pool) {
+  auto block = std::make_unique<Block>();
+  block->memory = allocateMemory(pool.memoryType, pool.blockSize, &block->mapped);
+
+  if (pool.strategy == AllocationStrategy::Buddy) {
+    block->freeNodes.resize(pool.maxOrder + 1);
+    block->freeNodes[pool.maxOrder].insert(0);
+  }
+
+  for (auto &slot : pool.blocks) {
+    if (!slot) {
+      slot = std::move(block);
+      return *slot;
+    }
+  }
+  pool.blocks.push_back(std::move(block));
+  return *pool.blocks.back();
+}
+
+VkDeviceMemory MemoryAllocator::allocateMemory(uint32_t memoryType, VkDeviceSize size,
+                                               void **mapped) {
+  VkMemoryAllocateInfo allocInfo = {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = size;
+  allocInfo.memoryTypeIndex = memoryType;
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+    throw std::runtime_error("Failed to allocate device memory!");
+  deviceAllocations++;
+
+  *mapped = nullptr;
+  if (memoryProperties.memoryTypes[memoryType].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+    if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, mapped) != VK_SUCCESS)
+      throw std::runtime_error("Failed to map device memory!");
+  }
+  return memory;
+}
+
+void MemoryAllocator::freeMemory(VkDeviceMemory memory, bool mapped) {
+  if (mapped) vkUnmapMemory(device, memory);
+  vkFreeMemory(device, memory, nullptr);
+  deviceAllocations--;
+}
+
+bool MemoryAllocator::allocateBuddy(Pool &pool, Block &block, VkDeviceSize size,
+                                    Allocation &out) {
+  const uint8_t order = static_cast<uint8_t>(std::countr_zero(size / MIN_NODE_SIZE));
+
+  uint8_t found = order;
+  while (found <= pool.maxOrder && block.freeNodes[found].empty())
+    found++;
+  if (found > pool.maxOrder) return false;
+
+  VkDeviceSize offset = *block.freeNodes[found].begin();
+  block.freeNodes[found].erase(block.freeNodes[found].begin());
+
+  // Split down to the requested order, keeping the upper halves free
+  while (found > order) {
+    found--;
+    block.freeNodes[found].insert(offset + (MIN_NODE_SIZE << found));
+  }
+
+  out.offset = offset;
+  out.order = order;
+  return true;
+}
+
+void MemoryAllocator::freeBuddy(Pool &pool, Block &block, VkDeviceSize offset,
+                                uint8_t order) {
+  while (order < pool.maxOrder) {
+    const VkDeviceSize buddy = offset ^ (MIN_NODE_SIZE << order);
+    auto it = block.freeNodes[order].find(buddy);
+    if (it == block.freeNodes[order].end()) break;
+
+    block.freeNodes[order].erase(it);
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  block.freeNodes[order].insert(offset);
+}
+
+bool MemoryAllocator::allocateLinear(Pool &pool, Block &block, VkDeviceSize size,
+                                     VkDeviceSize alignment, Allocation &out) {
+  const VkDeviceSize offset = alignUp(block.head, alignment);
+  if (offset + size > pool.blockSize) return false;
+
+  block.head = offset + size;
+  block.liveCount++;
+  out.offset = offset;
+  return true;
+}
+
+} // namespace Magma
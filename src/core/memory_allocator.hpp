@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+/**
+ * Region of device memory handed out by the MemoryAllocator.
+ * Resources bind at (memory, offset); host-visible allocations carry a
+ * pointer into their persistently mapped block.
+ */
+struct Allocation {
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  void *mapped = nullptr;
+
+  // Allocator bookkeeping
+  uint32_t pool = 0;
+  uint32_t block = 0;
+  uint8_t order = 0;
+  bool dedicated = false;
+
+  bool valid() const { return memory != VK_NULL_HANDLE; }
+};
+
+enum class AllocationStrategy {
+  Buddy,  // general purpose, power-of-two blocks with coalescing
+  Linear  // bump allocation for short-lived resources such as staging buffers
+};
+
+/**
+ * Pooled device memory allocator.
+ * Keeps block pools per memory type and resource kind, so buffers and
+ * optimal-tiling images never share a block and bufferImageGranularity
+ * can't be violated. Requests too large for a block get a dedicated
+ * allocation. Host-visible blocks are mapped once for their whole lifetime.
+ */
+class MemoryAllocator {
+public:
+  enum class ResourceKind : uint8_t {
+    Buffer,
+    Image
+  };
+
+  MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device);
+  ~MemoryAllocator();
+
+  MemoryAllocator(const MemoryAllocator &) = delete;
+  MemoryAllocator &operator=(const MemoryAllocator &) = delete;
+
+  Allocation allocate(const VkMemoryRequirements &requirements,
+                      VkMemoryPropertyFlags properties, ResourceKind kind,
+                      AllocationStrategy strategy = AllocationStrategy::Buddy);
+  void free(const Allocation &allocation);
+
+  void flush(const Allocation &allocation, VkDeviceSize size = VK_WHOLE_SIZE,
+             VkDeviceSize offset = 0);
+
+  uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+  /** Number of live vkAllocateMemory objects, for diagnostics */
+  uint32_t deviceAllocationCount() const { return deviceAllocations; }
+
+private:
+  static constexpr VkDeviceSize MIN_NODE_SIZE = 256;
+  static constexpr VkDeviceSize MAX_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+  struct Block {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void *mapped = nullptr;
+
+    // Buddy: free node offsets per order (node size = MIN_NODE_SIZE << order)
+    std::vector<std::set<VkDeviceSize>> freeNodes;
+
+    // Linear: bump pointer, rewound when the last allocation is freed
+    VkDeviceSize head = 0;
+    uint32_t liveCount = 0;
+  };
+
+  struct Pool {
+    uint32_t memoryType = 0;
+    ResourceKind kind = ResourceKind::Buffer;
+    AllocationStrategy strategy = AllocationStrategy::Buddy;
+    VkDeviceSize blockSize = 0;
+    uint8_t maxOrder = 0;
+    bool hostVisible = false;
+    std::vector<std::unique_ptr<Block>> blocks;
+  };
+
+  VkDevice device;
+  VkPhysicalDeviceMemoryProperties memoryProperties{};
+  VkDeviceSize nonCoherentAtomSize = 1;
+  uint32_t deviceAllocations = 0;
+  std::vector<Pool> pools;
+  std::mutex mutex;
+
+  uint32_t findPool(uint32_t memoryType, ResourceKind kind, AllocationStrategy strategy);
+  Block &addBlock(Pool &pool);
+  VkDeviceMemory allocateMemory(uint32_t memoryType, VkDeviceSize size, void **mapped);
+  void freeMemory(VkDeviceMemory memory, bool mapped);
+
+  bool allocateBuddy(Pool &pool, Block &block, VkDeviceSize size, Allocation &out);
+  void freeBuddy(Pool &pool, Block &block, VkDeviceSize offset, uint8_t order);
+  bool allocateLinear(Pool &pool, Block &block, VkDeviceSize size,
+                      VkDeviceSize alignment, Allocation &out);
+};
+
+} // namespace Magma
@@ -2,7 +2,6 @@
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <vector>
-#include <vulkan/vulkan_core.h>
 
 namespace Magma {
 
@@ -11,18 +10,31 @@ struct MeshData {
     glm::vec3 position{0.f, 0.f, 0.f};
     glm::vec3 normal{0.f, 0.f, 0.f};
     glm::vec3 color{1.f, 1.f, 1.f};
+  };
+
+  /** Ranges of one glTF primitive; its indices already include firstVertex */
+  struct Submesh {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+  };
 
-    static std::vector<VkVertexInputBindingDescription>
-    getBindingDescriptions();
-    static std::vector<VkVertexInputAttributeDescription>
-    getAttributeDescriptions();
+  /**
+   * Index range of one level of detail covering every submesh. Levels share
+   * the vertex stream; lods[0] is the full mesh and error is the object space
+   * deviation from it.
+   */
+  struct Lod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.f;
   };
 
   std::vector<Vertex> vertices;
   std::vector<uint32_t> indices;
-
-  uint32_t vertexOffset = 0;
-  uint32_t indexOffset = 0;
+  std::vector<Submesh> submeshes;
+  std::vector<Lod> lods;
 };
 
 } // namespace Magma
@@ -1,13 +1,13 @@
 #pragma once
 #include <cstdint>
+#include <glm/ext/matrix_float3x4.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
 
-struct ObjectData {
+// Matches the std430 layout of ObjectData in the vertex shaders (stride 128);
+// the normal matrix is a std430 mat3, three vec4 columns.
+struct alignas(16) ObjectData {
   glm::mat4 modelMatrix{1.f};
-  glm::mat4 normalMatrix{1.f};
+  glm::mat3x4 normalMatrix{1.f};
   uint32_t objectID;
 };
-
-struct ObjectStorageSSBO {
-  ObjectData objects[1024] = {};
-};
+static_assert(sizeof(ObjectData) == 128, "ObjectData must match the shader stride");
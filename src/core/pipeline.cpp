@@ -1,5 +1,4 @@
 #include "pipeline.hpp"
-#include "mesh_data.hpp"
 #include "render_system.hpp"
 #include <cassert>
 #include <cstdint>
@@ -51,7 +50,12 @@ void Pipeline::createGraphicsPipeline(const std::string &vertFilepath,
   shaderStages[0].pName = "main";
   shaderStages[0].flags = 0;
   shaderStages[0].pNext = nullptr;
-  shaderStages[0].pSpecializationInfo = nullptr;
+  // Specialization constant 0 tells the vertex shader how normals are stored
+  const uint32_t vertexLayout = static_cast<uint32_t>(configInfo.vertexLayout);
+  VkSpecializationMapEntry layoutEntry{0, 0, sizeof(uint32_t)};
+  VkSpecializationInfo vertexSpecialization{1, &layoutEntry, sizeof(uint32_t),
+                                            &vertexLayout};
+  shaderStages[0].pSpecializationInfo = &vertexSpecialization;
 
   shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
   shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -61,8 +65,8 @@ void Pipeline::createGraphicsPipeline(const std::string &vertFilepath,
   shaderStages[1].pNext = nullptr;
   shaderStages[1].pSpecializationInfo = nullptr;
 
-  auto bindingDescriptions = MeshData::Vertex::getBindingDescriptions();
-  auto attributeDescriptions = MeshData::Vertex::getAttributeDescriptions();
+  auto bindingDescriptions = VertexLayouts::bindingDescriptions(configInfo.vertexLayout);
+  auto attributeDescriptions = VertexLayouts::attributeDescriptions(configInfo.vertexLayout);
 
   VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
   vertexInputInfo.sType =
@@ -1,4 +1,5 @@
 #pragma once
+#include "vertex_layout.hpp"
 #include <string>
 #include <vector>
 #include <vulkan/vulkan_core.h>
@@ -23,6 +24,7 @@ struct PipelineConfigInfo {
   std::vector<VkDynamicState> dynamicStates;
   VkPipelineDynamicStateCreateInfo dynamicStateInfo;
   VkPipelineLayout pipelineLayout = nullptr;
+  VertexLayout vertexLayout = VertexLayout::Standard;
 
   std::vector<VkFormat> colorAttachmentFormats;
   VkFormat depthFormat = VK_FORMAT_UNDEFINED;
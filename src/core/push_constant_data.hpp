@@ -1,11 +1,10 @@
 #pragma once
 
-#include <glm/mat4x4.hpp>
+#include <cstdint>
 namespace Magma {
 
+// Instance slots of draw i in a multi-draw start at gl_InstanceIndex + i * stride
 struct PushConstantData {
-  glm::mat4 modelMatrix{1.f};
-  glm::mat4 normalMatrix{1.f};
-  uint32_t objectId = 0;
+  uint32_t instanceStride = 0;
 };
 } // namespace Magma
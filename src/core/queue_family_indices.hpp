@@ -6,6 +6,8 @@ namespace Magma {
 struct QueueFamilyIndices {
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  // Transfer-only family for async uploads, absent on some devices
+  std::optional<uint32_t> transferFamily;
   bool isComplete() {
     return graphicsFamily.has_value() && presentFamily.has_value();
   }
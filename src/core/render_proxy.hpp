@@ -1,24 +1,32 @@
 #pragma once
-#include "core/mesh_data.hpp"
+#include "vertex_layout.hpp"
+#include <glm/ext/matrix_float3x4.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
 #include <optional>
 #include <vulkan/vulkan_core.h>
 
 namespace Magma {
 
+class CookedMesh;
+
 struct MeshProxy {
-    MeshData *meshData;
+    const CookedMesh *asset = nullptr;
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
     VkBuffer indexBuffer  = VK_NULL_HANDLE;
     uint32_t indexCount   = 0;
     uint32_t vertexCount  = 0;
+    uint32_t firstIndex   = 0;  // offsets into buffers shared by several meshes
+    int32_t  vertexOffset = 0;
     bool     hasIndexBuffer = false;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    VertexLayout vertexLayout = VertexLayout::Standard; // selects the pipeline variant
 };
 
 struct TransformProxy {
     glm::mat4 modelMatrix{1.f};
-    glm::mat4 normalMatrix{1.f};
+    glm::mat3x4 normalMatrix{1.f};
     uint32_t  objectId = 0;
+    uint32_t  version  = 0; // bumped by Transform whenever the matrices change
 };
 
 struct PointLightProxy {
@@ -28,6 +36,8 @@ struct PointLightProxy {
 
 struct CameraProxy {
     glm::mat4 projView{1.f};
+    glm::vec3 position{0.f};
+    float lodScale = 0.f; // projection[1][1] / 2: world size at distance 1 in screen heights
 };
 
 // A complete renderable object — built by GameObject each frame
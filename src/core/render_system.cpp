@@ -1,6 +1,7 @@
 #include "render_system.hpp"
 #include "core/device.hpp"
 #include "core/frame_info.hpp"
+#include "core/upload_service.hpp"
 #include "core/window.hpp"
 #include "deletion_queue.hpp"
 #include "engine/render/scene_renderer.hpp"
@@ -21,19 +22,27 @@
 
 namespace Magma {
 
-RenderSystem::RenderSystem(Window &window) : window{window} {
-  device = std::make_unique<Device>(window);
+RenderSystem::RenderSystem(Window &window, const DeviceSpecification &deviceSpec)
+    : window{window} {
+  device = std::make_unique<Device>(window, deviceSpec);
   renderContext = std::make_unique<RenderContext>();
+  meshRegistry = std::make_unique<MeshRegistry>();
   createCommandBuffers();
 }
 
 RenderSystem::~RenderSystem() {
   Device::waitIdle();
 
+  // Let queued uploads finish so their staging goes through the queue below
+  UploadService &uploads = Device::uploads();
+  uploads.wait(uploads.submit());
+  uploads.collect();
+
   // Destroy scenes before the device so mesh vertex/index buffers are
   // pushed to the DeletionQueue while it can still be flushed.
   SceneManager::scenes.clear();
 
+  meshRegistry.reset();
   renderContext.reset();
   destroyAllRenderers();
 
@@ -67,6 +76,7 @@ void RenderSystem::onRender() {
   #endif
 
   if (beginFrame()) {
+    extractFrame();
     renderFrame();
     endFrame();
   }
@@ -134,12 +144,35 @@ bool RenderSystem::beginFrame() {
 
   FrameInfo::commandBuffer = commandBuffer;
 
+  // This frame slot's fence has been waited on, its deferred deletions are safe
+  DeletionQueue::flushForFrame(FrameInfo::frameIndex);
+
   return true;
 }
 
+void RenderSystem::extractFrame() {
+  for (auto &renderer : sceneRenderers)
+    renderer->syncActiveCameraAspect();
+
+  // Finished loads are queued for upload before meshes look at their assets
+  meshRegistry->update();
+  sceneExtractor.extract(SceneManager::activeScene, *renderContext, frameArena);
+
+  // Ship the uploads queued so far and acquire the batches that completed;
+  // the swapchain submit waits on their (already signalled) timeline value
+  UploadService &uploads = Device::uploads();
+  uploads.submit();
+  uploads.recordAcquires(FrameInfo::commandBuffer);
+
+  renderContext->uploadObjects(FrameInfo::commandBuffer, FrameInfo::frameIndex);
+}
+
 void RenderSystem::renderFrame() {
-  for (auto &renderer : sceneRenderers) 
+  const FrameSnapshot &snapshot = sceneExtractor.snapshot();
+  for (auto &renderer : sceneRenderers) {
+    renderer->prepareView(snapshot);
     renderer->onRender();
+  }
 
   #if defined (MAGMA_WITH_EDITOR)
     imguiRenderer->onRender();
@@ -159,6 +192,13 @@ void RenderSystem::endFrame() {
         result = renderer->getSwapChain()->submitCommandBuffer(&FrameInfo::commandBuffer);
   #endif
 
+  // Recording is done, the snapshot's draw lists are no longer referenced
+  frameArena.reset();
+
+  // Removals retire their GPU resources into this frame's DeletionQueue slot,
+  // which is only flushed once the frame just submitted has finished
+  if (SceneManager::activeScene) SceneManager::activeScene->processDeferredActions();
+
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
       window.wasWindowResized()) {
     onWindowResize();
@@ -167,8 +207,6 @@ void RenderSystem::endFrame() {
     throw std::runtime_error("Failed to present swap chain image!");
 
   FrameInfo::advanceFrame(SwapChain::MAX_FRAMES_IN_FLIGHT);
-  if (SceneManager::activeScene) SceneManager::activeScene->processDeferredActions();
-  DeletionQueue::flushForFrame(FrameInfo::frameIndex);
 }
 
 // Resize handling
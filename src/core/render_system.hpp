@@ -4,8 +4,11 @@
   #include "engine/render/imgui_renderer.hpp"
 #endif
 
+#include "engine/assets/mesh_registry.hpp"
 #include "engine/render/render_context.hpp"
 #include "device.hpp"
+#include "frame_arena.hpp"
+#include "engine/render/scene_extractor.hpp"
 #include "engine/render/scene_renderer.hpp"
 #include "frame_info.hpp"
 #include <memory>
@@ -17,7 +20,7 @@ class Window;
 
 class RenderSystem {
 public:
-  RenderSystem(Window &window);
+  RenderSystem(Window &window, const DeviceSpecification &deviceSpec = {});
   ~RenderSystem();
 
   #if defined (MAGMA_WITH_EDITOR)
@@ -30,6 +33,8 @@ private:
   Window &window;
   std::unique_ptr<Device> device = nullptr;
   std::unique_ptr<RenderContext> renderContext = nullptr;
+  // Destroyed before the RenderContext, its geometry lives in the arena
+  std::unique_ptr<MeshRegistry> meshRegistry = nullptr;
 
   /** Swap chain 
    * Manages the presentation to the window
@@ -44,9 +49,17 @@ private:
   std::vector<std::unique_ptr<SceneRenderer>> sceneRenderers;
   void resizeSwapChainRenderer(const VkExtent2D extent);
 
+  /** Scene extraction
+   * Walks the active scene once per frame and uploads the shared object and
+   * light data consumed by every scene renderer
+   * */
+  SceneExtractor sceneExtractor;
+  FrameArena frameArena;
+
   void destroyAllRenderers();
 
   bool beginFrame();
+  void extractFrame();
   void renderFrame();
   void endFrame();
 
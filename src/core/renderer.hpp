@@ -1,5 +1,6 @@
 #pragma once
 #include "core/swapchain.hpp"
+#include "core/vertex_layout.hpp"
 #include "engine/render/pipeline_shader_info.hpp"
 #include <vector>
 #include <vulkan/vulkan_core.h>
@@ -12,6 +13,8 @@ public:
   virtual void destroy() = 0;
 
   virtual VkPipelineLayout getPipelineLayout() const = 0;
+  /** Binds the pipeline variant reading the given vertex layout, if any */
+  virtual void bindPipeline(VertexLayout) {}
 
   // Rendering
   virtual void onResize(const VkExtent2D extent) = 0;
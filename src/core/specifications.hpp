@@ -10,4 +10,14 @@ struct WindowSpecification {
   uint32_t windowHeight;
 };
 
+struct JobSystemSpecification {
+  // Worker threads besides the main thread; 0 takes one per remaining core
+  uint32_t workerCount = 0;
+};
+
+struct DeviceSpecification {
+  // Persistently mapped staging ring shared by all host-to-device uploads
+  uint64_t stagingRingSize = 32ull * 1024 * 1024;
+};
+
 } // namespace Magma
@@ -0,0 +1,61 @@
+#include "staging_ring.hpp"
+#include "device.hpp"
+#include <stdexcept>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+StagingRing::StagingRing(VkDeviceSize capacity) : capacity_{capacity} {
+  Device::get().createBuffer(
+      capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      buffer, memory);
+
+  if (!memory.mapped)
+    throw std::runtime_error("StagingRing: staging memory is not host visible!");
+}
+
+StagingRing::~StagingRing() {
+  vkDestroyBuffer(Device::get().device(), buffer, nullptr);
+  Device::freeMemory(memory);
+}
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+StagingRegion StagingRing::allocate(VkDeviceSize size, uint64_t timelineValue) {
+  if (size == 0 || size > capacity_) return {};
+
+  VkDeviceSize start = (head + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  VkDeviceSize offset = start % capacity_;
+
+  // Regions never straddle the end of the ring, skip the remainder instead
+  if (offset + size > capacity_) {
+    start += capacity_ - offset;
+    offset = 0;
+  }
+  if (start + size - tail > capacity_) return {};
+
+  head = start + size;
+  if (!spans.empty() && spans.back().timelineValue == timelineValue)
+    spans.back().end = head;
+  else
+    spans.push_back({head, timelineValue});
+
+  StagingRegion region{};
+  region.buffer = buffer;
+  region.offset = offset;
+  region.size = size;
+  region.data = static_cast<char *>(memory.mapped) + offset;
+  return region;
+}
+
+void StagingRing::reclaim(uint64_t completedValue) {
+  while (!spans.empty() && spans.front().timelineValue <= completedValue) {
+    tail = spans.front().end;
+    spans.pop_front();
+  }
+}
+
+} // namespace Magma
@@ -0,0 +1,59 @@
+#pragma once
+#include "memory_allocator.hpp"
+#include <cstdint>
+#include <deque>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+/** Slice of the staging ring, writable through `data` until it is submitted */
+struct StagingRegion {
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  void *data = nullptr;
+
+  bool valid() const { return data != nullptr; }
+};
+
+/**
+ * Persistently mapped host-visible ring used as the source of all uploads.
+ * Each region is tagged with the upload timeline value of the batch that
+ * reads it and is reclaimed once the timeline has passed that value, so
+ * staging never creates Vulkan objects after startup.
+ */
+class StagingRing {
+public:
+  static constexpr VkDeviceSize ALIGNMENT = 16;
+
+  explicit StagingRing(VkDeviceSize capacity);
+  ~StagingRing();
+
+  StagingRing(const StagingRing &) = delete;
+  StagingRing &operator=(const StagingRing &) = delete;
+
+  /** Returns an invalid region when the ring is too full right now */
+  StagingRegion allocate(VkDeviceSize size, uint64_t timelineValue);
+  /** Reclaims every region whose batch has completed */
+  void reclaim(uint64_t completedValue);
+
+  VkDeviceSize capacity() const { return capacity_; }
+  bool empty() const { return head == tail; }
+
+private:
+  struct Span {
+    VkDeviceSize end = 0; // monotonic position past the span
+    uint64_t timelineValue = 0;
+  };
+
+  VkBuffer buffer = VK_NULL_HANDLE;
+  Allocation memory{};
+  VkDeviceSize capacity_ = 0;
+
+  // Monotonic byte positions, the ring offset is position % capacity
+  VkDeviceSize head = 0;
+  VkDeviceSize tail = 0;
+  std::deque<Span> spans;
+};
+
+} // namespace Magma
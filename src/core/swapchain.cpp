@@ -3,6 +3,7 @@
 #include "frame_info.hpp"
 #include "queue_family_indices.hpp"
 #include "render_target_info.hpp"
+#include "upload_service.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -87,16 +88,27 @@ VkResult SwapChain::submitCommandBuffer(const VkCommandBuffer *commandBuffer) {
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = commandBuffer;
 
-  // Wait for the image to be acquired submit
+  // Wait for the image to be acquired submit, and for the upload batches
+  // this frame acquired
+  const UploadWait uploadWait = Device::uploads().takeGraphicsWait();
   VkSemaphore waitSemaphores[] = {
-      imageAcquiredSemaphores[FrameInfo::frameIndex]};
+      imageAcquiredSemaphores[FrameInfo::frameIndex],
+      Device::uploads().timeline()};
   // Wait in the color attachment output stage
   VkPipelineStageFlags waitStages[] = {
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-  submitInfo.waitSemaphoreCount = 1;
+      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, uploadWait.stages};
+  // Binary semaphores ignore their timeline value
+  uint64_t waitValues[] = {0, uploadWait.value};
+  submitInfo.waitSemaphoreCount = uploadWait.value ? 2 : 1;
   submitInfo.pWaitSemaphores = waitSemaphores;
   submitInfo.pWaitDstStageMask = waitStages;
 
+  VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+  timelineInfo.pWaitSemaphoreValues = waitValues;
+  submitInfo.pNext = &timelineInfo;
+
   // Signal that rendering is complete
   VkSemaphore signalSemaphores[] = {
       renderCompleteSemaphores[FrameInfo::imageIndex]};
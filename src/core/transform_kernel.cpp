@@ -0,0 +1,203 @@
+#include "transform_kernel.hpp"
+#include <cmath>
+
+#if defined(__AVX2__) || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+  #include <immintrin.h>
+  #define MAGMA_TRANSFORM_AVX2 1
+  #if defined(__AVX2__)
+    #define MAGMA_AVX2_TARGET
+  #else
+    #define MAGMA_AVX2_TARGET __attribute__((target("avx2")))
+  #endif
+#endif
+
+namespace Magma {
+
+namespace {
+
+// Cephes sinf/cosf: angles are reduced to [-pi/4, pi/4] around the nearest
+// even multiple of pi/4, with pi/4 split in three so the reduction stays
+// exact, then both minimax polynomials are evaluated on the remainder
+constexpr float kFourOverPi = 1.27323954473516f;
+constexpr float kPiOver4A = 0.78515625f;
+constexpr float kPiOver4B = 2.4187564849853515625e-4f;
+constexpr float kPiOver4C = 3.77489497744594108e-8f;
+constexpr float kSin0 = -1.9515295891e-4f;
+constexpr float kSin1 = 8.3321608736e-3f;
+constexpr float kSin2 = -1.6666654611e-1f;
+constexpr float kCos0 = 2.443315711809948e-5f;
+constexpr float kCos1 = -1.388731625493765e-3f;
+constexpr float kCos2 = 4.166664568298827e-2f;
+
+/** Scaled rotation columns: 9 model values, then 9 normal values */
+constexpr uint32_t kBasisCount = 18;
+
+void writeMatrices(const TransformStreams &t, uint32_t i, const float *basis,
+                   uint32_t stride, glm::mat4 &model, glm::mat3x4 &normal) {
+  auto at = [&](uint32_t element) { return basis[element * stride]; };
+  model = glm::mat4{{at(0), at(1), at(2), 0.f},
+                    {at(3), at(4), at(5), 0.f},
+                    {at(6), at(7), at(8), 0.f},
+                    {t.positionX[i], t.positionY[i], t.positionZ[i], 1.f}};
+  normal = glm::mat3x4{{at(9), at(10), at(11), 0.f},
+                       {at(12), at(13), at(14), 0.f},
+                       {at(15), at(16), at(17), 0.f}};
+}
+
+void composeScalar(const TransformStreams &t, uint32_t i, glm::mat4 &model,
+                   glm::mat3x4 &normal) {
+  float s1, c1, s2, c2, s3, c3;
+  TransformKernel::sincos(t.rotationY[i], s1, c1);
+  TransformKernel::sincos(t.rotationX[i], s2, c2);
+  TransformKernel::sincos(t.rotationZ[i], s3, c3);
+  const float rotation[9] = {
+      c1 * c3 + s1 * s2 * s3, c2 * s3, c1 * s2 * s3 - s1 * c3,
+      s1 * s2 * c3 - s3 * c1, c2 * c3, s1 * s3 + c1 * s2 * c3,
+      s1 * c2,                -s2,     c1 * c2,
+  };
+  const float scale[3] = {t.scaleX[i], t.scaleY[i], t.scaleZ[i]};
+
+  float basis[kBasisCount];
+  for (uint32_t column = 0; column < 3; ++column) {
+    const float invScale = 1.f / scale[column];
+    for (uint32_t row = 0; row < 3; ++row) {
+      basis[column * 3 + row] = rotation[column * 3 + row] * scale[column];
+      basis[9 + column * 3 + row] = rotation[column * 3 + row] * invScale;
+    }
+  }
+  writeMatrices(t, i, basis, 1, model, normal);
+}
+
+#if defined(MAGMA_TRANSFORM_AVX2)
+MAGMA_AVX2_TARGET
+void sincosAvx2(__m256 x, __m256 &sine, __m256 &cosine) {
+  const __m256 signMask = _mm256_set1_ps(-0.f);
+  const __m256i two = _mm256_set1_epi32(2);
+  const __m256i four = _mm256_set1_epi32(4);
+
+  __m256 sineSign = _mm256_and_ps(x, signMask);
+  x = _mm256_andnot_ps(signMask, x);
+
+  __m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kFourOverPi)));
+  octant = _mm256_and_si256(_mm256_add_epi32(octant, _mm256_set1_epi32(1)),
+                            _mm256_set1_epi32(~1));
+  const __m256 y = _mm256_cvtepi32_ps(octant);
+
+  sineSign = _mm256_xor_ps(sineSign, _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_and_si256(octant, four), 29)));
+  const __m256 cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+      _mm256_andnot_si256(_mm256_sub_epi32(octant, two), four), 29));
+  const __m256 swap =
+      _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(octant, two), two));
+
+  x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kPiOver4A)));
+  x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kPiOver4B)));
+  x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kPiOver4C)));
+  const __m256 z = _mm256_mul_ps(x, x);
+
+  __m256 cosP = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kCos0), z), _mm256_set1_ps(kCos1));
+  cosP = _mm256_add_ps(_mm256_mul_ps(cosP, z), _mm256_set1_ps(kCos2));
+  cosP = _mm256_mul_ps(_mm256_mul_ps(cosP, z), z);
+  cosP = _mm256_sub_ps(cosP, _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+  cosP = _mm256_add_ps(cosP, _mm256_set1_ps(1.f));
+
+  __m256 sinP = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kSin0), z), _mm256_set1_ps(kSin1));
+  sinP = _mm256_add_ps(_mm256_mul_ps(sinP, z), _mm256_set1_ps(kSin2));
+  sinP = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinP, z), x), x);
+
+  sine = _mm256_xor_ps(_mm256_blendv_ps(sinP, cosP, swap), sineSign);
+  cosine = _mm256_xor_ps(_mm256_blendv_ps(cosP, sinP, swap), cosineSign);
+}
+
+/** Composes the 8 transforms starting at i */
+MAGMA_AVX2_TARGET
+void composeAvx2(const TransformStreams &t, uint32_t i, glm::mat4 *models,
+                 glm::mat3x4 *normals) {
+  __m256 s1, c1, s2, c2, s3, c3;
+  sincosAvx2(_mm256_loadu_ps(t.rotationY + i), s1, c1);
+  sincosAvx2(_mm256_loadu_ps(t.rotationX + i), s2, c2);
+  sincosAvx2(_mm256_loadu_ps(t.rotationZ + i), s3, c3);
+
+  const __m256 s1s2 = _mm256_mul_ps(s1, s2);
+  const __m256 c1s2 = _mm256_mul_ps(c1, s2);
+  const __m256 rotation[9] = {
+      _mm256_add_ps(_mm256_mul_ps(c1, c3), _mm256_mul_ps(s1s2, s3)),
+      _mm256_mul_ps(c2, s3),
+      _mm256_sub_ps(_mm256_mul_ps(c1s2, s3), _mm256_mul_ps(s1, c3)),
+      _mm256_sub_ps(_mm256_mul_ps(s1s2, c3), _mm256_mul_ps(s3, c1)),
+      _mm256_mul_ps(c2, c3),
+      _mm256_add_ps(_mm256_mul_ps(s1, s3), _mm256_mul_ps(c1s2, c3)),
+      _mm256_mul_ps(s1, c2),
+      _mm256_xor_ps(s2, _mm256_set1_ps(-0.f)),
+      _mm256_mul_ps(c1, c2),
+  };
+  const __m256 scale[3] = {_mm256_loadu_ps(t.scaleX + i), _mm256_loadu_ps(t.scaleY + i),
+                           _mm256_loadu_ps(t.scaleZ + i)};
+
+  // Element-major, so each lane's values are 8 floats apart
+  alignas(32) float basis[kBasisCount * 8];
+  for (uint32_t column = 0; column < 3; ++column) {
+    const __m256 invScale = _mm256_div_ps(_mm256_set1_ps(1.f), scale[column]);
+    for (uint32_t row = 0; row < 3; ++row) {
+      const __m256 r = rotation[column * 3 + row];
+      _mm256_store_ps(basis + (column * 3 + row) * 8, _mm256_mul_ps(r, scale[column]));
+      _mm256_store_ps(basis + (9 + column * 3 + row) * 8, _mm256_mul_ps(r, invScale));
+    }
+  }
+  for (uint32_t lane = 0; lane < 8; ++lane)
+    writeMatrices(t, i + lane, basis + lane, 8, models[i + lane], normals[i + lane]);
+}
+
+bool hasAvx2() {
+  #if defined(__AVX2__)
+    return true;
+  #else
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+  #endif
+}
+#endif
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void TransformKernel::compose(const TransformStreams &transforms, uint32_t count,
+                              glm::mat4 *models, glm::mat3x4 *normals) {
+  uint32_t i = 0;
+  #if defined(MAGMA_TRANSFORM_AVX2)
+    if (hasAvx2())
+      for (; i + 8 <= count; i += 8)
+        composeAvx2(transforms, i, models, normals);
+  #endif
+  for (; i < count; ++i)
+    composeScalar(transforms, i, models[i], normals[i]);
+}
+
+void TransformKernel::sincos(float angle, float &sine, float &cosine) {
+  float x = std::abs(angle);
+  const int32_t octant = (static_cast<int32_t>(x * kFourOverPi) + 1) & ~1;
+  const float y = static_cast<float>(octant);
+  x = ((x - y * kPiOver4A) - y * kPiOver4B) - y * kPiOver4C;
+  const float z = x * x;
+
+  const float cosP = ((kCos0 * z + kCos1) * z + kCos2) * z * z - 0.5f * z + 1.f;
+  const float sinP = ((kSin0 * z + kSin1) * z + kSin2) * z * x + x;
+
+  const bool swap = (octant & 2) != 0;
+  sine = swap ? cosP : sinP;
+  cosine = swap ? sinP : cosP;
+  if (((octant & 4) != 0) != std::signbit(angle)) sine = -sine;
+  if (((octant - 2) & 4) == 0) cosine = -cosine;
+}
+
+const char *TransformKernel::simdPath() {
+  #if defined(MAGMA_TRANSFORM_AVX2)
+    if (hasAvx2()) return "AVX2";
+  #endif
+  return "Scalar";
+}
+
+} // namespace Magma
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Magma {
+
+/**
+ * Local transforms in SoA layout, one lane per transform. Rotations are
+ * Tait-Bryan angles in radians applied as Y, X, Z, like Transform.
+ */
+struct TransformStreams {
+  const float *positionX = nullptr, *positionY = nullptr, *positionZ = nullptr;
+  const float *rotationX = nullptr, *rotationY = nullptr, *rotationZ = nullptr;
+  const float *scaleX = nullptr, *scaleY = nullptr, *scaleZ = nullptr;
+};
+
+/**
+ * Builds model and normal matrices of many transforms in one pass, sharing
+ * one sincos per angle between both. Runs 8 lanes at a time with AVX2 when
+ * the CPU supports it and one at a time otherwise; both paths use the same
+ * polynomial sincos, so results don't depend on the path taken.
+ */
+class TransformKernel {
+public:
+  /**
+   * Writes models[i] and normals[i] for every i < count. Normal matrices
+   * are the inverse transpose of the model's upper 3x3, stored as three
+   * vec4 columns to match a std430 mat3.
+   */
+  static void compose(const TransformStreams &transforms, uint32_t count,
+                      glm::mat4 *models, glm::mat3x4 *normals);
+
+  /** Scalar sincos with the kernel's range reduction and polynomials */
+  static void sincos(float angle, float &sine, float &cosine);
+
+  /** Name of the path compose() takes on this CPU */
+  static const char *simdPath();
+};
+
+} // namespace Magma
@@ -0,0 +1,382 @@
+#include "upload_service.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+UploadService::UploadService(VkDevice device, VkQueue transferQueue,
+                             uint32_t transferFamily, uint32_t graphicsFamily,
+                             VkDeviceSize stagingSize)
+    : device{device}, queue{transferQueue}, transferFamily{transferFamily},
+      graphicsFamily{graphicsFamily} {
+  VkCommandPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolInfo.queueFamilyIndex = transferFamily;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
+                   VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+  if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    throw std::runtime_error("UploadService: failed to create command pool!");
+
+  VkSemaphoreTypeCreateInfo typeInfo = {};
+  typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  typeInfo.initialValue = 0;
+
+  VkSemaphoreCreateInfo semaphoreInfo = {};
+  semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  semaphoreInfo.pNext = &typeInfo;
+
+  if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &timeline_) != VK_SUCCESS)
+    throw std::runtime_error("UploadService: failed to create timeline semaphore!");
+
+  ring = std::make_unique<StagingRing>(stagingSize);
+}
+
+UploadService::~UploadService() {
+  wait(submittedValue);
+
+  open.reset();
+  inFlight.clear();
+  freeBatches.clear();
+  ring.reset();
+
+  vkDestroySemaphore(device, timeline_, nullptr);
+  vkDestroyCommandPool(device, commandPool, nullptr);
+}
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void UploadService::upload(VkBuffer dst, VkDeviceSize dstOffset, const void *data,
+                           VkDeviceSize size, VkPipelineStageFlags dstStages,
+                           VkAccessFlags dstAccess) {
+  std::lock_guard lock(mutex);
+
+  // Quarter-ring chunks let large uploads pipeline with the batches ahead
+  const VkDeviceSize maxChunk = ring->capacity() / 4;
+  const char *src = static_cast<const char *>(data);
+  for (VkDeviceSize done = 0; done < size;) {
+    const VkDeviceSize chunk = std::min(size - done, maxChunk);
+    StagingRegion region = stageLocked(chunk);
+    memcpy(region.data, src + done, chunk);
+
+    VkBufferCopy copy = {};
+    copy.srcOffset = region.offset;
+    copy.dstOffset = dstOffset + done;
+    copy.size = chunk;
+    recordBufferCopy(region.buffer, dst, copy, dstStages, dstAccess);
+    done += chunk;
+  }
+}
+
+void UploadService::uploadImage(VkImage image, uint32_t width, uint32_t height,
+                                const void *data, VkDeviceSize size) {
+  std::lock_guard lock(mutex);
+
+  if (size <= ring->capacity()) {
+    StagingRegion region = stageLocked(size);
+    memcpy(region.data, data, size);
+    recordImageCopy(region.buffer, region.offset, image, width, height);
+    return;
+  }
+
+  // Images can't be split by bytes; oversized ones get their own staging
+  auto staging = std::make_unique<Buffer>(
+      size, 1, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  staging->map();
+  staging->writeToBuffer(const_cast<void *>(data), size);
+  recordImageCopy(staging->getBuffer(), 0, image, width, height);
+  openBatch().staging.push_back(std::move(staging));
+}
+
+void UploadService::copyBuffer(VkBuffer src, VkBuffer dst, const VkBufferCopy &region,
+                               VkPipelineStageFlags dstStages, VkAccessFlags dstAccess) {
+  std::lock_guard lock(mutex);
+  recordBufferCopy(src, dst, region, dstStages, dstAccess);
+}
+
+void UploadService::copyBufferToImage(VkBuffer src, VkImage image, uint32_t width,
+                                      uint32_t height) {
+  std::lock_guard lock(mutex);
+  recordImageCopy(src, 0, image, width, height);
+}
+
+void UploadService::retain(std::unique_ptr<Buffer> staging) {
+  std::lock_guard lock(mutex);
+  openBatch().staging.push_back(std::move(staging));
+}
+
+uint64_t UploadService::submit() {
+  std::lock_guard lock(mutex);
+  return submitLocked();
+}
+
+void UploadService::recordAcquires(VkCommandBuffer commandBuffer) {
+  std::lock_guard lock(mutex);
+  if (pendingAcquires.empty()) return;
+
+  const uint64_t completed = completedValue();
+  VkPipelineStageFlags stages = 0;
+  while (!pendingAcquires.empty() && pendingAcquires.front().value <= completed) {
+    PendingAcquire &pending = pendingAcquires.front();
+    bufferAcquires.insert(bufferAcquires.end(), pending.buffers.begin(),
+                          pending.buffers.end());
+    imageAcquires.insert(imageAcquires.end(), pending.images.begin(),
+                         pending.images.end());
+    stages |= pending.stages;
+    graphicsWait.value = pending.value;
+    pendingAcquires.pop_front();
+  }
+  if (stages == 0) return;
+  graphicsWait.stages |= stages;
+
+  // Acquires start from the stages the timeline wait blocks, so they chain after it
+  if (!bufferAcquires.empty() || !imageAcquires.empty())
+    vkCmdPipelineBarrier(commandBuffer, stages, stages, 0, 0, nullptr,
+                         static_cast<uint32_t>(bufferAcquires.size()),
+                         bufferAcquires.data(),
+                         static_cast<uint32_t>(imageAcquires.size()),
+                         imageAcquires.data());
+
+  bufferAcquires.clear();
+  imageAcquires.clear();
+}
+
+UploadWait UploadService::takeGraphicsWait() {
+  std::lock_guard lock(mutex);
+  UploadWait wait = graphicsWait;
+  graphicsWait = {};
+  return wait;
+}
+
+uint64_t UploadService::pendingValue() {
+  std::lock_guard lock(mutex);
+  return open ? submittedValue + 1 : submittedValue;
+}
+
+uint64_t UploadService::completedValue() const {
+  uint64_t value = 0;
+  vkGetSemaphoreCounterValue(device, timeline_, &value);
+  return value;
+}
+
+void UploadService::wait(uint64_t value) const {
+  if (value == 0) return;
+
+  VkSemaphoreWaitInfo waitInfo = {};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &timeline_;
+  waitInfo.pValues = &value;
+  vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+}
+
+void UploadService::collect() {
+  std::lock_guard lock(mutex);
+  collectLocked();
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+void UploadService::recordBufferCopy(VkBuffer src, VkBuffer dst,
+                                     const VkBufferCopy &region,
+                                     VkPipelineStageFlags dstStages,
+                                     VkAccessFlags dstAccess) {
+  Batch &batch = openBatch();
+
+  vkCmdCopyBuffer(batch.commandBuffer, src, dst, 1, &region);
+  batch.dstStages |= dstStages;
+
+  if (!ownershipTransfer()) return;
+
+  VkBufferMemoryBarrier barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+  barrier.srcQueueFamilyIndex = transferFamily;
+  barrier.dstQueueFamilyIndex = graphicsFamily;
+  barrier.buffer = dst;
+  barrier.offset = region.dstOffset;
+  barrier.size = region.size;
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = 0;
+  batch.bufferReleases.push_back(barrier);
+
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = dstAccess;
+  batch.bufferAcquires.push_back(barrier);
+}
+
+void UploadService::recordImageCopy(VkBuffer src, VkDeviceSize srcOffset,
+                                    VkImage image, uint32_t width, uint32_t height) {
+  Batch &batch = openBatch();
+
+  VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.baseMipLevel = 0;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.baseArrayLayer = 0;
+  barrier.subresourceRange.layerCount = 1;
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                       1, &barrier);
+
+  VkBufferImageCopy region = {};
+  region.bufferOffset = srcOffset;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = {width, height, 1};
+
+  vkCmdCopyBufferToImage(batch.commandBuffer, src, image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  batch.dstStages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  if (!ownershipTransfer()) {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+    return;
+  }
+
+  // The layout transition happens once, as part of the ownership transfer
+  barrier.srcQueueFamilyIndex = transferFamily;
+  barrier.dstQueueFamilyIndex = graphicsFamily;
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = 0;
+  batch.imageReleases.push_back(barrier);
+
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  batch.imageAcquires.push_back(barrier);
+}
+
+uint64_t UploadService::submitLocked() {
+  collectLocked();
+  if (!open) return submittedValue;
+
+  Batch &batch = *open;
+  if (!batch.bufferReleases.empty() || !batch.imageReleases.empty())
+    vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         static_cast<uint32_t>(batch.bufferReleases.size()),
+                         batch.bufferReleases.data(),
+                         static_cast<uint32_t>(batch.imageReleases.size()),
+                         batch.imageReleases.data());
+
+  if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS)
+    throw std::runtime_error("UploadService: failed to record upload batch!");
+
+  batch.value = submittedValue + 1;
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.signalSemaphoreValueCount = 1;
+  timelineInfo.pSignalSemaphoreValues = &batch.value;
+
+  VkSubmitInfo submitInfo = {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.pNext = &timelineInfo;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &batch.commandBuffer;
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores = &timeline_;
+
+  if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    throw std::runtime_error("UploadService: failed to submit upload batch!");
+  submittedValue = batch.value;
+
+  PendingAcquire pending{};
+  pending.value = batch.value;
+  pending.stages = batch.dstStages ? batch.dstStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+  pending.buffers = batch.bufferAcquires;
+  pending.images = batch.imageAcquires;
+  pendingAcquires.push_back(std::move(pending));
+
+  inFlight.push_back(std::move(open));
+  return submittedValue;
+}
+
+StagingRegion UploadService::stageLocked(VkDeviceSize size) {
+  // Regions staged now are read by the open batch, which submits as the next value
+  for (;;) {
+    StagingRegion region = ring->allocate(size, submittedValue + 1);
+    if (region.valid()) return region;
+
+    // Ring is full: push the open batch out and wait for the oldest one
+    if (open) submitLocked();
+    if (inFlight.empty())
+      throw std::runtime_error("UploadService: upload does not fit the staging ring!");
+    wait(inFlight.front()->value);
+    collectLocked();
+  }
+}
+
+UploadService::Batch &UploadService::openBatch() {
+  if (open) return *open;
+
+  if (!freeBatches.empty()) {
+    open = std::move(freeBatches.back());
+    freeBatches.pop_back();
+  } else {
+    open = std::make_unique<Batch>();
+
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(device, &allocInfo, &open->commandBuffer) != VK_SUCCESS)
+      throw std::runtime_error("UploadService: failed to allocate command buffer!");
+  }
+
+  VkCommandBufferBeginInfo beginInfo = {};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(open->commandBuffer, &beginInfo);
+
+  return *open;
+}
+
+void UploadService::collectLocked() {
+  if (inFlight.empty()) return;
+
+  const uint64_t completed = completedValue();
+  ring->reclaim(completed);
+  while (!inFlight.empty() && inFlight.front()->value <= completed) {
+    std::unique_ptr<Batch> batch = std::move(inFlight.front());
+    inFlight.pop_front();
+
+    vkResetCommandBuffer(batch->commandBuffer, 0);
+    batch->dstStages = 0;
+    batch->bufferReleases.clear();
+    batch->imageReleases.clear();
+    batch->bufferAcquires.clear();
+    batch->imageAcquires.clear();
+    batch->staging.clear();
+    freeBatches.push_back(std::move(batch));
+  }
+}
+
+} // namespace Magma
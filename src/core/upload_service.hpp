@@ -0,0 +1,129 @@
+#pragma once
+#include "buffer.hpp"
+#include "staging_ring.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+/** Timeline point a graphics submit has to wait on before using uploads */
+struct UploadWait {
+  uint64_t value = 0;
+  VkPipelineStageFlags stages = 0;
+};
+
+/**
+ * Batches host-to-device copies onto the transfer queue.
+ * Copies are recorded into one open command buffer and go out in a single
+ * submit per frame, which signals the next value of a timeline semaphore.
+ * Consumers use an upload once isComplete() reports its value. The frame
+ * that first does so acquires the destinations from the transfer family (if
+ * a dedicated one exists) and waits on the already signalled value, so the
+ * graphics queue never stalls on a transfer in progress.
+ * Host data is staged through a persistently mapped StagingRing; uploads
+ * larger than the ring are split into chunks.
+ * @note Owned by the Device; reachable through Device::uploads()
+ */
+class UploadService {
+public:
+  static constexpr VkPipelineStageFlags DEFAULT_DST_STAGES =
+      VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  static constexpr VkAccessFlags DEFAULT_DST_ACCESS =
+      VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+      VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+  UploadService(VkDevice device, VkQueue transferQueue, uint32_t transferFamily,
+                uint32_t graphicsFamily, VkDeviceSize stagingSize);
+  ~UploadService();
+
+  UploadService(const UploadService &) = delete;
+  UploadService &operator=(const UploadService &) = delete;
+
+  /** Stages host data and queues its copy into dst, data can be reused on return */
+  void upload(VkBuffer dst, VkDeviceSize dstOffset, const void *data, VkDeviceSize size,
+              VkPipelineStageFlags dstStages = DEFAULT_DST_STAGES,
+              VkAccessFlags dstAccess = DEFAULT_DST_ACCESS);
+  void uploadImage(VkImage image, uint32_t width, uint32_t height, const void *data,
+                   VkDeviceSize size);
+
+  /** The source buffer has to stay alive until the batch completes, see retain() */
+  void copyBuffer(VkBuffer src, VkBuffer dst, const VkBufferCopy &region,
+                  VkPipelineStageFlags dstStages = DEFAULT_DST_STAGES,
+                  VkAccessFlags dstAccess = DEFAULT_DST_ACCESS);
+  /** Uploads mip 0 of a color image and leaves it shader-read-only */
+  void copyBufferToImage(VkBuffer src, VkImage image, uint32_t width, uint32_t height);
+  /** Keeps a staging buffer alive until the open batch has executed */
+  void retain(std::unique_ptr<Buffer> staging);
+
+  /** Submits the open batch; returns the timeline value marking its completion */
+  uint64_t submit();
+  /** Records acquires for completed batches into a graphics command buffer */
+  void recordAcquires(VkCommandBuffer commandBuffer);
+  /** Wait for the batches acquired since the last call, empty when there are none */
+  UploadWait takeGraphicsWait();
+
+  VkSemaphore timeline() const { return timeline_; }
+  /** Timeline value the copies queued so far will be complete at */
+  uint64_t pendingValue();
+  uint64_t completedValue() const;
+  bool isComplete(uint64_t value) const { return completedValue() >= value; }
+  void wait(uint64_t value) const;
+  /** Recycles command buffers and staging of completed batches */
+  void collect();
+
+private:
+  struct Batch {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    uint64_t value = 0;
+    VkPipelineStageFlags dstStages = 0;
+    std::vector<VkBufferMemoryBarrier> bufferReleases;
+    std::vector<VkImageMemoryBarrier> imageReleases;
+    std::vector<VkBufferMemoryBarrier> bufferAcquires;
+    std::vector<VkImageMemoryBarrier> imageAcquires;
+    std::vector<std::unique_ptr<Buffer>> staging;
+  };
+
+  VkDevice device;
+  VkQueue queue;
+  uint32_t transferFamily;
+  uint32_t graphicsFamily;
+  VkCommandPool commandPool = VK_NULL_HANDLE;
+  VkSemaphore timeline_ = VK_NULL_HANDLE;
+  std::unique_ptr<StagingRing> ring;
+
+  std::mutex mutex;
+  std::unique_ptr<Batch> open;
+  std::deque<std::unique_ptr<Batch>> inFlight;
+  std::vector<std::unique_ptr<Batch>> freeBatches;
+
+  // Submitted batches the graphics queue hasn't acquired yet
+  struct PendingAcquire {
+    uint64_t value = 0;
+    VkPipelineStageFlags stages = 0;
+    std::vector<VkBufferMemoryBarrier> buffers;
+    std::vector<VkImageMemoryBarrier> images;
+  };
+  std::deque<PendingAcquire> pendingAcquires;
+  std::vector<VkBufferMemoryBarrier> bufferAcquires;
+  std::vector<VkImageMemoryBarrier> imageAcquires;
+
+  uint64_t submittedValue = 0;
+  UploadWait graphicsWait{};
+
+  bool ownershipTransfer() const { return transferFamily != graphicsFamily; }
+  Batch &openBatch();
+  uint64_t submitLocked();
+  void collectLocked();
+  StagingRegion stageLocked(VkDeviceSize size);
+  void recordBufferCopy(VkBuffer src, VkBuffer dst, const VkBufferCopy &region,
+                        VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+  void recordImageCopy(VkBuffer src, VkDeviceSize srcOffset, VkImage image,
+                       uint32_t width, uint32_t height);
+};
+
+} // namespace Magma
@@ -0,0 +1,164 @@
+#include "vertex_layout.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include <limits>
+
+namespace Magma {
+
+namespace {
+
+struct CompactVertex {
+  glm::vec3 position;
+  int16_t normal[2];
+  uint8_t color[4];
+};
+static_assert(sizeof(CompactVertex) == 20);
+
+struct PackedVertex {
+  uint16_t position[4];
+  int16_t normal[2];
+  uint8_t color[4];
+};
+static_assert(sizeof(PackedVertex) == 16);
+
+/** Octahedral normal encoding, decoded by octDecode() in the vertex shaders */
+void encodeNormal(glm::vec3 n, int16_t out[2]) {
+  const float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+  glm::vec2 p = sum > 0.f ? glm::vec2{n.x, n.y} / sum : glm::vec2{0.f};
+  if (sum > 0.f && n.z < 0.f) {
+    const glm::vec2 folded{1.f - std::abs(p.y), 1.f - std::abs(p.x)};
+    p = {p.x >= 0.f ? folded.x : -folded.x, p.y >= 0.f ? folded.y : -folded.y};
+  }
+  out[0] = static_cast<int16_t>(std::round(std::clamp(p.x, -1.f, 1.f) * 32767.f));
+  out[1] = static_cast<int16_t>(std::round(std::clamp(p.y, -1.f, 1.f) * 32767.f));
+}
+
+void encodeColor(glm::vec3 c, uint8_t out[4]) {
+  out[0] = static_cast<uint8_t>(std::round(std::clamp(c.r, 0.f, 1.f) * 255.f));
+  out[1] = static_cast<uint8_t>(std::round(std::clamp(c.g, 0.f, 1.f) * 255.f));
+  out[2] = static_cast<uint8_t>(std::round(std::clamp(c.b, 0.f, 1.f) * 255.f));
+  out[3] = 255;
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+uint32_t VertexLayouts::stride(VertexLayout layout) {
+  switch (layout) {
+  case VertexLayout::Compact: return sizeof(CompactVertex);
+  case VertexLayout::Packed:  return sizeof(PackedVertex);
+  default:                    return sizeof(MeshData::Vertex);
+  }
+}
+
+const char *VertexLayouts::name(VertexLayout layout) {
+  switch (layout) {
+  case VertexLayout::Compact: return "Compact";
+  case VertexLayout::Packed:  return "Packed";
+  default:                    return "Standard";
+  }
+}
+
+std::vector<VkVertexInputBindingDescription>
+VertexLayouts::bindingDescriptions(VertexLayout layout) {
+  std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+  bindingDescriptions[0].binding = 0;
+  bindingDescriptions[0].stride = stride(layout);
+  bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+  return bindingDescriptions;
+}
+
+std::vector<VkVertexInputAttributeDescription>
+VertexLayouts::attributeDescriptions(VertexLayout layout) {
+  std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {};
+  switch (layout) {
+  case VertexLayout::Compact:
+    attributeDescriptions.push_back(
+        {0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(CompactVertex, position)});
+    attributeDescriptions.push_back(
+        {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, normal)});
+    attributeDescriptions.push_back(
+        {2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(CompactVertex, color)});
+    break;
+  case VertexLayout::Packed:
+    attributeDescriptions.push_back(
+        {0, 0, VK_FORMAT_R16G16B16A16_SFLOAT, offsetof(PackedVertex, position)});
+    attributeDescriptions.push_back(
+        {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal)});
+    attributeDescriptions.push_back(
+        {2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, color)});
+    break;
+  default:
+    attributeDescriptions.push_back(
+        {0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshData::Vertex, position)});
+    attributeDescriptions.push_back(
+        {1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshData::Vertex, normal)});
+    attributeDescriptions.push_back(
+        {2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshData::Vertex, color)});
+    break;
+  }
+  return attributeDescriptions;
+}
+
+VertexLayout VertexLayouts::select(std::span<const MeshData::Vertex> vertices) {
+  if (vertices.empty()) return VertexLayout::Packed;
+
+  glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+  glm::vec3 boundsMax{std::numeric_limits<float>::lowest()};
+  for (const MeshData::Vertex &vertex : vertices) {
+    // HDR or negative vertex colors don't survive RGBA8
+    if (glm::any(glm::lessThan(vertex.color, glm::vec3{0.f})) ||
+        glm::any(glm::greaterThan(vertex.color, glm::vec3{1.f})))
+      return VertexLayout::Standard;
+    boundsMin = glm::min(boundsMin, vertex.position);
+    boundsMax = glm::max(boundsMax, vertex.position);
+  }
+
+  const glm::vec3 extent = boundsMax - boundsMin;
+  const float tolerance = std::max({extent.x, extent.y, extent.z}) / 4096.f;
+  for (const MeshData::Vertex &vertex : vertices) {
+    for (int c = 0; c < 3; ++c) {
+      const float value = vertex.position[c];
+      const float rounded = glm::unpackHalf1x16(glm::packHalf1x16(value));
+      if (!std::isfinite(rounded) || std::abs(rounded - value) > tolerance)
+        return VertexLayout::Compact;
+    }
+  }
+  return VertexLayout::Packed;
+}
+
+void VertexLayouts::encode(VertexLayout layout, std::span<const MeshData::Vertex> vertices,
+                           std::byte *dst) {
+  switch (layout) {
+  case VertexLayout::Compact:
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      CompactVertex out{};
+      out.position = vertices[i].position;
+      encodeNormal(vertices[i].normal, out.normal);
+      encodeColor(vertices[i].color, out.color);
+      std::memcpy(dst + i * sizeof(out), &out, sizeof(out));
+    }
+    break;
+  case VertexLayout::Packed:
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      PackedVertex out{};
+      for (int c = 0; c < 3; ++c)
+        out.position[c] = glm::packHalf1x16(vertices[i].position[c]);
+      out.position[3] = glm::packHalf1x16(1.f);
+      encodeNormal(vertices[i].normal, out.normal);
+      encodeColor(vertices[i].color, out.color);
+      std::memcpy(dst + i * sizeof(out), &out, sizeof(out));
+    }
+    break;
+  default:
+    std::memcpy(dst, vertices.data(), vertices.size_bytes());
+    break;
+  }
+}
+
+} // namespace Magma
@@ -0,0 +1,44 @@
+#pragma once
+#include "mesh_data.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+/**
+ * Vertex stream formats a cooked mesh can be stored in. Every layout feeds
+ * the same shader inputs; the pipeline for a layout passes it as
+ * specialization constant 0 so the shader knows when to decode normals.
+ */
+enum class VertexLayout : uint8_t {
+  Standard, // float3 position, float3 normal, float3 color  (36 bytes)
+  Compact,  // float3 position, octahedral snorm16 normal, rgba8 color  (20 bytes)
+  Packed,   // half4 position, octahedral snorm16 normal, rgba8 color  (16 bytes)
+  Count
+};
+
+inline constexpr size_t VERTEX_LAYOUT_COUNT = static_cast<size_t>(VertexLayout::Count);
+
+class VertexLayouts {
+public:
+  static uint32_t stride(VertexLayout layout);
+  static const char *name(VertexLayout layout);
+
+  static std::vector<VkVertexInputBindingDescription> bindingDescriptions(VertexLayout layout);
+  static std::vector<VkVertexInputAttributeDescription> attributeDescriptions(VertexLayout layout);
+
+  /**
+   * Most compact layout that keeps the mesh within tolerance: half positions
+   * must stay within 1/4096 of the mesh extent, and colors must fit RGBA8.
+   */
+  static VertexLayout select(std::span<const MeshData::Vertex> vertices);
+  /** Writes vertices.size() * stride(layout) bytes to dst */
+  static void encode(VertexLayout layout, std::span<const MeshData::Vertex> vertices,
+                     std::byte *dst);
+};
+
+} // namespace Magma
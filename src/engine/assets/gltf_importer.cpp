@@ -0,0 +1,497 @@
+#include "gltf_importer.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/matrix.hpp>
+#include <limits>
+#include <print>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+#define TINYGLTF3_IMPLEMENTATION
+#define TINYGLTF3_ENABLE_FS          // enable file I/O
+#define TINYGLTF3_ENABLE_STB_IMAGE   // enable image decoding
+#include "tiny_gltf.h"
+
+namespace Magma {
+
+namespace {
+
+// Validated, bounds-checked window onto an accessor's elements
+struct AccessorView {
+  const uint8_t *data = nullptr; // null for accessors without a buffer view (all zeros)
+  size_t stride = 0;
+  size_t count = 0;
+  int32_t componentType = 0;
+  uint32_t components = 0;
+  bool normalized = false;
+};
+
+bool viewAccessor(const tg3_model &model, int32_t index, AccessorView &view) {
+  if (index < 0 || static_cast<uint32_t>(index) >= model.accessors_count)
+    return false;
+
+  const tg3_accessor &accessor = model.accessors[index];
+  const int32_t componentSize = tg3_component_size(accessor.component_type);
+  const int32_t components = tg3_num_components(accessor.type);
+  if (componentSize <= 0 || components <= 0 || components > 4)
+    return false;
+  if (accessor.sparse.is_sparse)
+    std::println("glTF accessor {} is sparse, only its dense part is imported", index);
+
+  view = {};
+  view.count = accessor.count;
+  view.componentType = accessor.component_type;
+  view.components = static_cast<uint32_t>(components);
+  view.normalized = accessor.normalized != 0;
+  if (accessor.buffer_view < 0) return true;
+
+  if (static_cast<uint32_t>(accessor.buffer_view) >= model.buffer_views_count)
+    return false;
+  const tg3_buffer_view &bufferView = model.buffer_views[accessor.buffer_view];
+  if (bufferView.buffer < 0 || static_cast<uint32_t>(bufferView.buffer) >= model.buffers_count)
+    return false;
+  const tg3_buffer &buffer = model.buffers[bufferView.buffer];
+
+  const size_t elementSize = static_cast<size_t>(componentSize) * components;
+  view.stride = bufferView.byte_stride ? bufferView.byte_stride : elementSize;
+
+  // The last element must end inside both the view and the buffer
+  if (view.count > 0) {
+    const uint64_t end = accessor.byte_offset + view.stride * (view.count - 1) + elementSize;
+    if (end > bufferView.byte_length ||
+        bufferView.byte_offset + bufferView.byte_length > buffer.data.count)
+      return false;
+  }
+  view.data = buffer.data.data + bufferView.byte_offset + accessor.byte_offset;
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Attribute kernels: strided source elements to floats in the vertex stream
+// ----------------------------------------------------------------------------
+
+template <typename T>
+constexpr float normalizeScale() {
+  if constexpr (std::is_floating_point_v<T>) return 1.f;
+  else return 1.f / static_cast<float>(std::numeric_limits<T>::max());
+}
+
+template <typename T>
+void gatherScalar(const AccessorView &src, uint32_t width, std::byte *dst, size_t dstStride) {
+  const float scale = src.normalized ? normalizeScale<T>() : 1.f;
+  const bool clamp = src.normalized && std::is_signed_v<T> && std::is_integral_v<T>;
+
+  for (size_t i = 0; i < src.count; ++i) {
+    T element[4] = {};
+    std::memcpy(element, src.data + i * src.stride, src.components * sizeof(T));
+    float lanes[4];
+    for (uint32_t c = 0; c < 4; ++c) {
+      lanes[c] = static_cast<float>(element[c]) * scale;
+      if (clamp) lanes[c] = std::max(lanes[c], -1.f);
+    }
+    std::memcpy(dst + i * dstStride, lanes, width * sizeof(float));
+  }
+}
+
+#if defined(__SSE2__)
+/** Widens one element's components into four float lanes */
+template <typename T>
+__m128 loadLanes(const uint8_t *src, uint32_t components) {
+  alignas(16) uint8_t bytes[16] = {};
+  std::memcpy(bytes, src, components * sizeof(T));
+  const __m128i raw = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+  const __m128i zero = _mm_setzero_si128();
+
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm_castsi128_ps(raw);
+  } else if constexpr (std::is_same_v<T, uint8_t>) {
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(raw, zero), zero));
+  } else if constexpr (std::is_same_v<T, int8_t>) {
+    // Replicate each byte across its lane, then sign extend from the top
+    const __m128i pairs = _mm_unpacklo_epi8(raw, raw);
+    const __m128i wide = _mm_unpacklo_epi16(pairs, pairs);
+    return _mm_cvtepi32_ps(_mm_srai_epi32(wide, 24));
+  } else if constexpr (std::is_same_v<T, uint16_t>) {
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, zero));
+  } else {
+    static_assert(std::is_same_v<T, int16_t>);
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16));
+  }
+}
+
+template <typename T>
+void gatherSse(const AccessorView &src, uint32_t width, std::byte *dst, size_t dstStride) {
+  const __m128 scale = _mm_set1_ps(src.normalized ? normalizeScale<T>() : 1.f);
+  const __m128 minusOne = _mm_set1_ps(-1.f);
+  const bool clamp = src.normalized && std::is_signed_v<T> && std::is_integral_v<T>;
+
+  const uint8_t *element = src.data;
+  for (size_t i = 0; i < src.count; ++i, element += src.stride) {
+    __m128 lanes = _mm_mul_ps(loadLanes<T>(element, src.components), scale);
+    if (clamp) lanes = _mm_max_ps(lanes, minusOne);
+
+    alignas(16) float out[4];
+    _mm_store_ps(out, lanes);
+    std::memcpy(dst + i * dstStride, out, width * sizeof(float));
+  }
+}
+#endif
+
+template <typename T>
+void gather(const AccessorView &src, uint32_t width, std::byte *dst, size_t dstStride) {
+  #if defined(__SSE2__)
+    if constexpr (sizeof(T) <= 2 || std::is_same_v<T, float>)
+      return gatherSse<T>(src, width, dst, dstStride);
+  #endif
+  gatherScalar<T>(src, width, dst, dstStride);
+}
+
+/** Writes `width` floats per element; false for unsupported component types */
+bool gatherAttribute(const AccessorView &src, uint32_t width, std::byte *dst, size_t dstStride) {
+  width = std::min(width, src.components);
+  if (!src.data) {
+    for (size_t i = 0; i < src.count; ++i)
+      std::memset(dst + i * dstStride, 0, width * sizeof(float));
+    return true;
+  }
+
+  switch (src.componentType) {
+  case TG3_COMPONENT_TYPE_FLOAT:          gather<float>(src, width, dst, dstStride); return true;
+  case TG3_COMPONENT_TYPE_UNSIGNED_BYTE:  gather<uint8_t>(src, width, dst, dstStride); return true;
+  case TG3_COMPONENT_TYPE_BYTE:           gather<int8_t>(src, width, dst, dstStride); return true;
+  case TG3_COMPONENT_TYPE_UNSIGNED_SHORT: gather<uint16_t>(src, width, dst, dstStride); return true;
+  case TG3_COMPONENT_TYPE_SHORT:          gather<int16_t>(src, width, dst, dstStride); return true;
+  case TG3_COMPONENT_TYPE_UNSIGNED_INT:   gather<uint32_t>(src, width, dst, dstStride); return true;
+  default: return false;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Index kernels: 8/16/32-bit source indices to uint32
+// ----------------------------------------------------------------------------
+
+template <typename T>
+void widenIndices(const AccessorView &src, uint32_t *dst) {
+  size_t i = 0;
+  #if defined(__SSE2__)
+    if constexpr (std::is_same_v<T, uint16_t>) {
+      // Tightly packed 16-bit indices are the common case, eight per step
+      if (src.stride == sizeof(T)) {
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= src.count; i += 8) {
+          const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src.data + i * 2));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi16(raw, zero));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4), _mm_unpackhi_epi16(raw, zero));
+        }
+      }
+    }
+  #endif
+  for (; i < src.count; ++i) {
+    T index;
+    std::memcpy(&index, src.data + i * src.stride, sizeof(T));
+    dst[i] = index;
+  }
+}
+
+bool gatherIndices(const AccessorView &src, uint32_t *dst) {
+  if (!src.data || src.components != 1) return false;
+  switch (src.componentType) {
+  case TG3_COMPONENT_TYPE_UNSIGNED_BYTE:  widenIndices<uint8_t>(src, dst); return true;
+  case TG3_COMPONENT_TYPE_UNSIGNED_SHORT: widenIndices<uint16_t>(src, dst); return true;
+  case TG3_COMPONENT_TYPE_UNSIGNED_INT:   widenIndices<uint32_t>(src, dst); return true;
+  default: return false;
+  }
+}
+
+/** Rewrites strips and fans in place as triangle lists */
+void triangulate(int32_t mode, std::vector<uint32_t> &indices) {
+  if (mode != TG3_MODE_TRIANGLE_STRIP && mode != TG3_MODE_TRIANGLE_FAN) return;
+
+  std::vector<uint32_t> list;
+  list.reserve(indices.size() >= 3 ? (indices.size() - 2) * 3 : 0);
+  for (size_t i = 2; i < indices.size(); ++i) {
+    if (mode == TG3_MODE_TRIANGLE_FAN)
+      list.insert(list.end(), {indices[0], indices[i - 1], indices[i]});
+    else if (i % 2 == 0)
+      list.insert(list.end(), {indices[i - 2], indices[i - 1], indices[i]});
+    else
+      list.insert(list.end(), {indices[i - 1], indices[i - 2], indices[i]});
+  }
+  indices = std::move(list);
+}
+
+// ----------------------------------------------------------------------------
+// Scene traversal
+// ----------------------------------------------------------------------------
+
+struct PrimitiveInstance {
+  const tg3_primitive *primitive = nullptr;
+  glm::mat4 transform{1.f};
+};
+
+int32_t findAttribute(const tg3_primitive &primitive, std::string_view name) {
+  for (uint32_t i = 0; i < primitive.attributes_count; ++i) {
+    const tg3_str &key = primitive.attributes[i].key;
+    if (std::string_view{key.data, key.len} == name)
+      return primitive.attributes[i].value;
+  }
+  return TG3_INDEX_NONE;
+}
+
+bool isTriangles(const tg3_primitive &primitive) {
+  return primitive.mode < 0 || primitive.mode == TG3_MODE_TRIANGLES ||
+         primitive.mode == TG3_MODE_TRIANGLE_STRIP ||
+         primitive.mode == TG3_MODE_TRIANGLE_FAN;
+}
+
+glm::mat4 localMatrix(const tg3_node &node) {
+  if (node.has_matrix)
+    return glm::mat4{glm::make_mat4(node.matrix)};
+
+  const glm::vec3 translation{glm::make_vec3(node.translation)};
+  const glm::quat rotation{static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]),
+                           static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2])};
+  const glm::vec3 scale{glm::make_vec3(node.scale)};
+
+  glm::mat4 matrix = glm::mat4_cast(rotation);
+  matrix[0] *= scale.x;
+  matrix[1] *= scale.y;
+  matrix[2] *= scale.z;
+  matrix[3] = glm::vec4{translation, 1.f};
+  return matrix;
+}
+
+/** Every triangle primitive placed by the default scene, or each mesh once without one */
+std::vector<PrimitiveInstance> collectPrimitives(const tg3_model &model) {
+  std::vector<PrimitiveInstance> instances;
+  auto addMesh = [&](int32_t meshIndex, const glm::mat4 &transform) {
+    if (meshIndex < 0 || static_cast<uint32_t>(meshIndex) >= model.meshes_count) return;
+    const tg3_mesh &mesh = model.meshes[meshIndex];
+    for (uint32_t p = 0; p < mesh.primitives_count; ++p) {
+      if (isTriangles(mesh.primitives[p]))
+        instances.push_back({&mesh.primitives[p], transform});
+    }
+  };
+
+  const int32_t sceneIndex = model.default_scene >= 0 ? model.default_scene : 0;
+  if (static_cast<uint32_t>(sceneIndex) >= model.scenes_count) {
+    for (uint32_t m = 0; m < model.meshes_count; ++m)
+      addMesh(static_cast<int32_t>(m), glm::mat4{1.f});
+    return instances;
+  }
+
+  // Depth-first with a bounded depth, malformed files may contain cycles
+  struct Entry { int32_t node; glm::mat4 parent; uint32_t depth; };
+  std::vector<Entry> stack;
+  const tg3_scene &scene = model.scenes[sceneIndex];
+  for (uint32_t i = scene.nodes_count; i-- > 0;)
+    stack.push_back({scene.nodes[i], glm::mat4{1.f}, 0});
+
+  while (!stack.empty()) {
+    const Entry entry = stack.back();
+    stack.pop_back();
+    if (entry.node < 0 || static_cast<uint32_t>(entry.node) >= model.nodes_count ||
+        entry.depth > 64)
+      continue;
+
+    const tg3_node &node = model.nodes[entry.node];
+    const glm::mat4 world = entry.parent * localMatrix(node);
+    addMesh(node.mesh, world);
+    for (uint32_t c = node.children_count; c-- > 0;)
+      stack.push_back({node.children[c], world, entry.depth + 1});
+  }
+  return instances;
+}
+
+// ----------------------------------------------------------------------------
+// Primitive import
+// ----------------------------------------------------------------------------
+
+void generateNormals(MeshData &mesh, size_t firstVertex, size_t firstIndex) {
+  for (size_t i = firstIndex; i + 2 < mesh.indices.size(); i += 3) {
+    MeshData::Vertex &a = mesh.vertices[mesh.indices[i]];
+    MeshData::Vertex &b = mesh.vertices[mesh.indices[i + 1]];
+    MeshData::Vertex &c = mesh.vertices[mesh.indices[i + 2]];
+    // Unnormalized cross product weights each face by its area
+    const glm::vec3 face = glm::cross(b.position - a.position, c.position - a.position);
+    a.normal += face;
+    b.normal += face;
+    c.normal += face;
+  }
+  for (size_t v = firstVertex; v < mesh.vertices.size(); ++v) {
+    const float length = glm::length(mesh.vertices[v].normal);
+    mesh.vertices[v].normal = length > 0.f ? mesh.vertices[v].normal / length
+                                           : glm::vec3{0.f, 1.f, 0.f};
+  }
+}
+
+void applyTransform(MeshData &mesh, size_t firstVertex, size_t firstIndex,
+                    const glm::mat4 &transform) {
+  if (transform == glm::mat4{1.f}) return;
+
+  const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3{transform}));
+  for (size_t v = firstVertex; v < mesh.vertices.size(); ++v) {
+    MeshData::Vertex &vertex = mesh.vertices[v];
+    vertex.position = glm::vec3{transform * glm::vec4{vertex.position, 1.f}};
+    const glm::vec3 normal = normalMatrix * vertex.normal;
+    const float length = glm::length(normal);
+    if (length > 0.f) vertex.normal = normal / length;
+  }
+
+  // Mirroring transforms flip the winding
+  if (glm::determinant(glm::mat3{transform}) < 0.f) {
+    for (size_t i = firstIndex; i + 2 < mesh.indices.size(); i += 3)
+      std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+  }
+}
+
+bool appendPrimitive(const tg3_model &model, const PrimitiveInstance &instance,
+                     std::vector<uint32_t> &scratch, MeshData &mesh) {
+  const tg3_primitive &primitive = *instance.primitive;
+
+  AccessorView positions;
+  if (!viewAccessor(model, findAttribute(primitive, "POSITION"), positions) ||
+      positions.components != 3 || positions.count == 0)
+    return false;
+
+  const size_t firstVertex = mesh.vertices.size();
+  const size_t firstIndex = mesh.indices.size();
+  const size_t vertexCount = positions.count;
+  constexpr size_t stride = sizeof(MeshData::Vertex);
+
+  mesh.vertices.resize(firstVertex + vertexCount);
+  auto *vertices = reinterpret_cast<std::byte *>(mesh.vertices.data() + firstVertex);
+  auto rollback = [&]() {
+    mesh.vertices.resize(firstVertex);
+    mesh.indices.resize(firstIndex);
+    return false;
+  };
+
+  if (!gatherAttribute(positions, 3, vertices + offsetof(MeshData::Vertex, position), stride))
+    return rollback();
+
+  AccessorView normals;
+  const bool hasNormals =
+      viewAccessor(model, findAttribute(primitive, "NORMAL"), normals) &&
+      normals.components == 3 && normals.count == vertexCount &&
+      gatherAttribute(normals, 3, vertices + offsetof(MeshData::Vertex, normal), stride);
+
+  AccessorView colors;
+  if (viewAccessor(model, findAttribute(primitive, "COLOR_0"), colors) &&
+      colors.components >= 3 && colors.count == vertexCount)
+    gatherAttribute(colors, 3, vertices + offsetof(MeshData::Vertex, color), stride);
+
+  // Non-indexed primitives get a trivial index list so the mesh draws as one
+  scratch.clear();
+  if (primitive.indices != TG3_INDEX_NONE) {
+    AccessorView indices;
+    if (!viewAccessor(model, primitive.indices, indices))
+      return rollback();
+    scratch.resize(indices.count);
+    if (!gatherIndices(indices, scratch.data()))
+      return rollback();
+  } else {
+    scratch.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+      scratch[i] = static_cast<uint32_t>(i);
+  }
+  triangulate(primitive.mode, scratch);
+  scratch.resize(scratch.size() - scratch.size() % 3);
+
+  mesh.indices.resize(firstIndex + scratch.size());
+  uint32_t *indices = mesh.indices.data() + firstIndex;
+  const uint32_t base = static_cast<uint32_t>(firstVertex);
+  for (size_t i = 0; i < scratch.size(); ++i) {
+    if (scratch[i] >= vertexCount)
+      return rollback();
+    indices[i] = scratch[i] + base;
+  }
+
+  if (!hasNormals)
+    generateNormals(mesh, firstVertex, firstIndex);
+  applyTransform(mesh, firstVertex, firstIndex, instance.transform);
+
+  MeshData::Submesh submesh{};
+  submesh.firstIndex = static_cast<uint32_t>(firstIndex);
+  submesh.indexCount = static_cast<uint32_t>(scratch.size());
+  submesh.firstVertex = base;
+  submesh.vertexCount = static_cast<uint32_t>(vertexCount);
+  mesh.submeshes.push_back(submesh);
+  return true;
+}
+
+/** Upper bounds of the streams so they are allocated once */
+void reserveStreams(const tg3_model &model, const std::vector<PrimitiveInstance> &instances,
+                    MeshData &mesh) {
+  size_t vertexCount = 0;
+  size_t indexCount = 0;
+  for (const PrimitiveInstance &instance : instances) {
+    const int32_t position = findAttribute(*instance.primitive, "POSITION");
+    if (position < 0 || static_cast<uint32_t>(position) >= model.accessors_count) continue;
+    const size_t vertices = model.accessors[position].count;
+
+    const int32_t indices = instance.primitive->indices;
+    size_t count = vertices;
+    if (indices >= 0 && static_cast<uint32_t>(indices) < model.accessors_count)
+      count = model.accessors[indices].count;
+    if (instance.primitive->mode == TG3_MODE_TRIANGLE_STRIP ||
+        instance.primitive->mode == TG3_MODE_TRIANGLE_FAN)
+      count = count >= 3 ? (count - 2) * 3 : 0;
+
+    vertexCount += vertices;
+    indexCount += count;
+  }
+  mesh.vertices.reserve(vertexCount);
+  mesh.indices.reserve(indexCount);
+  mesh.submeshes.reserve(instances.size());
+}
+
+} // namespace
+
+std::unique_ptr<MeshData> GltfImporter::import(const std::string &filepath) {
+  tg3_parse_options opts;
+  tg3_parse_options_init(&opts);
+  opts.images_as_is = 1;   // textures aren't part of the mesh
+  opts.parse_float32 = 1;
+  tg3_error_stack errors = {};
+  tg3_model model = {};
+
+  tg3_error_code result = tg3_parse_file(&model, &errors,
+      filepath.c_str(), (uint32_t)filepath.size(), &opts);
+
+  if (result != TG3_OK) {
+    for (uint32_t i = 0; i < errors.count; i++) {
+      const tg3_error_entry *e = tg3_errors_get(&errors, i);
+      fprintf(stderr, "[%d] %s\n", (int)e->severity, e->message);
+    }
+    tg3_error_stack_free(&errors);
+    tg3_model_free(&model);
+    return nullptr;
+  }
+  tg3_error_stack_free(&errors);
+  std::println("Loading glTF model: {}", filepath);
+
+  const std::vector<PrimitiveInstance> instances = collectPrimitives(model);
+  auto meshData = std::make_unique<MeshData>();
+  reserveStreams(model, instances, *meshData);
+
+  std::vector<uint32_t> scratch;
+  for (const PrimitiveInstance &instance : instances) {
+    if (!appendPrimitive(model, instance, scratch, *meshData))
+      std::println("Skipped malformed primitive in {}", filepath);
+  }
+
+  tg3_model_free(&model);
+  return meshData;
+}
+
+} // namespace Magma
@@ -0,0 +1,20 @@
+#pragma once
+#include "core/mesh_data.hpp"
+#include <memory>
+#include <string>
+
+namespace Magma {
+
+/**
+ * Decodes glTF files into MeshData, only used when (re)cooking a mesh.
+ * Every triangle primitive placed by the default scene becomes a submesh
+ * with its node transform baked in; accessors of any component type,
+ * stride and normalization are widened to the engine vertex layout.
+ */
+class GltfImporter {
+public:
+  /** Returns nullptr if the file can't be parsed */
+  static std::unique_ptr<MeshData> import(const std::string &filepath);
+};
+
+} // namespace Magma
@@ -0,0 +1,146 @@
+#include "mesh_cooker.hpp"
+#include "core/hash.hpp"
+#include "core/mapped_file.hpp"
+#include "gltf_importer.hpp"
+#include "mesh_optimizer.hpp"
+#include "mesh_simplifier.hpp"
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <print>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace Magma {
+
+std::unique_ptr<CookedMesh> MeshCooker::load(const std::string &sourcePath) {
+  const fs::path source{sourcePath};
+  const fs::path cooked = cookedPath(source);
+  const std::vector<fs::path> files = dependencies(source);
+  const uint64_t stamp = stampFiles(files);
+
+  std::unique_ptr<CookedMesh> cached = CookedMesh::fromFile(MappedFile{cooked.string()});
+  if (cached && cached->header().sourceStamp == stamp)
+    return cached;
+
+  // Stamps change on checkout or copy, only the content decides staleness
+  const uint64_t hash = hashFiles(files);
+  if (cached && cached->header().sourceHash == hash) {
+    restamp(cooked, stamp);
+    return cached;
+  }
+  cached.reset();
+
+  std::unique_ptr<MeshData> mesh = GltfImporter::import(sourcePath);
+  if (!mesh) return nullptr;
+
+  const float acmrBefore = MeshOptimizer::averageCacheMissRatio(
+      mesh->indices, static_cast<uint32_t>(mesh->vertices.size()));
+  const size_t verticesBefore = mesh->vertices.size();
+  MeshOptimizer::optimize(*mesh);
+  std::println("Cooking mesh: {} ({} -> {} vertices, ACMR {:.2f} -> {:.2f})",
+               cooked.string(), verticesBefore, mesh->vertices.size(), acmrBefore,
+               MeshOptimizer::averageCacheMissRatio(
+                   mesh->indices, static_cast<uint32_t>(mesh->vertices.size())));
+  MeshSimplifier::generateLods(*mesh);
+  for (size_t lod = 1; lod < mesh->lods.size(); ++lod)
+    std::println("  LOD {}: {} triangles, error {:.4f}", lod,
+                 mesh->lods[lod].indexCount / 3, mesh->lods[lod].error);
+  std::vector<std::byte> bytes = CookedMesh::serialize(*mesh, hash, stamp);
+  write(cooked, bytes);
+  return CookedMesh::fromBytes(std::move(bytes));
+}
+
+fs::path MeshCooker::cookedPath(const fs::path &sourcePath) {
+  fs::path cooked = sourcePath;
+  cooked += EXTENSION;
+  return cooked;
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+std::vector<fs::path> MeshCooker::dependencies(const fs::path &source) {
+  std::vector<fs::path> files{source};
+
+  MappedFile json{source.string()};
+  if (!json.valid()) return files;
+
+  // glTF references buffers and images through "uri" strings; embedded data
+  // URIs are already covered by hashing the source itself
+  const std::string_view text{static_cast<const char *>(json.data()), json.size()};
+  constexpr std::string_view key = "\"uri\"";
+  for (size_t pos = text.find(key); pos != std::string_view::npos;
+       pos = text.find(key, pos + key.size())) {
+    const size_t open = text.find('"', text.find(':', pos + key.size()));
+    const size_t close = open == std::string_view::npos
+                             ? std::string_view::npos : text.find('"', open + 1);
+    if (close == std::string_view::npos) break;
+
+    const std::string_view uri = text.substr(open + 1, close - open - 1);
+    if (uri.empty() || uri.starts_with("data:")) continue;
+    files.push_back(source.parent_path() / fs::path{std::string{uri}});
+  }
+  return files;
+}
+
+uint64_t MeshCooker::stampFiles(const std::vector<fs::path> &files) {
+  uint64_t stamp = CookedMeshHeader::VERSION;
+  for (const fs::path &file : files) {
+    std::error_code error;
+    const auto size = fs::file_size(file, error);
+    const auto time = fs::last_write_time(file, error);
+    stamp = hashCombine(stamp, error ? 0 : static_cast<uint64_t>(size));
+    stamp = hashCombine(stamp, error ? 0 : static_cast<uint64_t>(time.time_since_epoch().count()));
+  }
+  return stamp;
+}
+
+uint64_t MeshCooker::hashFiles(const std::vector<fs::path> &files) {
+  uint64_t hash = CookedMeshHeader::VERSION;
+  for (const fs::path &file : files) {
+    MappedFile contents{file.string()};
+    hash = hashCombine(hash, contents.valid()
+                                 ? hashBytes(contents.data(), contents.size())
+                                 : 0);
+  }
+  return hash;
+}
+
+void MeshCooker::write(const fs::path &path, const std::vector<std::byte> &bytes) {
+  // Written aside and renamed so concurrent loads never map a partial file
+  fs::path temporary = path;
+  temporary += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  {
+    std::ofstream out{temporary, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+      std::println("Failed to write cooked mesh: {}", path.string());
+      out.close();
+      std::error_code error;
+      fs::remove(temporary, error);
+      return;
+    }
+  }
+
+  std::error_code error;
+  fs::rename(temporary, path, error);
+  if (error) {
+    std::println("Failed to write cooked mesh: {}", path.string());
+    fs::remove(temporary, error);
+  }
+}
+
+void MeshCooker::restamp(const fs::path &path, uint64_t sourceStamp) {
+  std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+  if (!file) return;
+  file.seekp(offsetof(CookedMeshHeader, sourceStamp));
+  file.write(reinterpret_cast<const char *>(&sourceStamp), sizeof(sourceStamp));
+}
+
+} // namespace Magma
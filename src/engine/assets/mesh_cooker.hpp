@@ -0,0 +1,35 @@
+#pragma once
+#include "core/cooked_mesh.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Magma {
+
+/**
+ * Turns glTF sources into `.magmamesh` files cached next to them.
+ * A cached file is reused while the content hash of the source and every
+ * file it references matches; file sizes and write times are compared first
+ * so an unchanged asset is never read. Safe to call from worker threads.
+ */
+class MeshCooker {
+public:
+  static constexpr const char *EXTENSION = ".magmamesh";
+
+  /** Returns nullptr if the source can't be cooked */
+  static std::unique_ptr<CookedMesh> load(const std::string &sourcePath);
+  static std::filesystem::path cookedPath(const std::filesystem::path &sourcePath);
+
+private:
+  /** The source followed by the external buffers and images it references */
+  static std::vector<std::filesystem::path> dependencies(const std::filesystem::path &source);
+  static uint64_t stampFiles(const std::vector<std::filesystem::path> &files);
+  static uint64_t hashFiles(const std::vector<std::filesystem::path> &files);
+
+  static void write(const std::filesystem::path &path, const std::vector<std::byte> &bytes);
+  static void restamp(const std::filesystem::path &path, uint64_t sourceStamp);
+};
+
+} // namespace Magma
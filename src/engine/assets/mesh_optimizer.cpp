@@ -0,0 +1,294 @@
+#include "mesh_optimizer.hpp"
+#include "core/hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace Magma {
+
+namespace {
+
+constexpr uint32_t NONE = ~0u;
+
+/** Deduplicates bitwise identical vertices, returns the unique vertex count */
+uint32_t weld(std::span<const MeshData::Vertex> vertices, std::vector<uint32_t> &remap,
+              std::vector<MeshData::Vertex> &unique) {
+  const size_t count = vertices.size();
+  size_t tableSize = 16;
+  while (tableSize < count * 2) tableSize *= 2;
+
+  // Open addressing over indices into `unique`
+  std::vector<uint32_t> table(tableSize, NONE);
+  remap.assign(count, NONE);
+  unique.clear();
+  unique.reserve(count);
+
+  for (size_t v = 0; v < count; ++v) {
+    const MeshData::Vertex &vertex = vertices[v];
+    size_t slot = hashBytes(&vertex, sizeof(vertex)) & (tableSize - 1);
+    while (table[slot] != NONE &&
+           std::memcmp(&unique[table[slot]], &vertex, sizeof(vertex)) != 0)
+      slot = (slot + 1) & (tableSize - 1);
+
+    if (table[slot] == NONE) {
+      table[slot] = static_cast<uint32_t>(unique.size());
+      unique.push_back(vertex);
+    }
+    remap[v] = table[slot];
+  }
+  return static_cast<uint32_t>(unique.size());
+}
+
+float vertexScore(int32_t cachePosition, uint32_t remainingValence) {
+  if (remainingValence == 0) return -1.f;
+
+  float score = 0.f;
+  if (cachePosition >= 0) {
+    // The last triangle's vertices get a fixed score so it isn't reused at once
+    constexpr uint32_t size = MeshOptimizer::CACHE_SIZE;
+    score = cachePosition < 3 ? 0.75f
+          : std::pow(1.f - static_cast<float>(cachePosition - 3) / (size - 3), 1.5f);
+  }
+  // Favour vertices with few triangles left so they leave the working set
+  return score + 2.f / std::sqrt(static_cast<float>(remainingValence));
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void MeshOptimizer::optimize(MeshData &mesh) {
+  MeshData optimized;
+  optimized.vertices.reserve(mesh.vertices.size());
+  optimized.indices.reserve(mesh.indices.size());
+  optimized.submeshes.reserve(mesh.submeshes.size());
+
+  std::vector<uint32_t> indices, remap, firstUse;
+  std::vector<MeshData::Vertex> unique;
+
+  for (const MeshData::Submesh &submesh : mesh.submeshes) {
+    const std::span<const MeshData::Vertex> vertices{
+        mesh.vertices.data() + submesh.firstVertex, submesh.vertexCount};
+    const uint32_t uniqueCount = weld(vertices, remap, unique);
+
+    indices.resize(submesh.indexCount);
+    for (uint32_t i = 0; i < submesh.indexCount; ++i)
+      indices[i] = remap[mesh.indices[submesh.firstIndex + i] - submesh.firstVertex];
+
+    optimizeVertexCache(indices, uniqueCount);
+    optimizeOverdraw(indices, unique);
+
+    // Number vertices in the order the index stream first touches them;
+    // vertices no triangle references are dropped
+    firstUse.assign(uniqueCount, NONE);
+    const uint32_t base = static_cast<uint32_t>(optimized.vertices.size());
+    uint32_t next = 0;
+    for (uint32_t &index : indices) {
+      if (firstUse[index] == NONE) {
+        firstUse[index] = next++;
+        optimized.vertices.push_back(unique[index]);
+      }
+      index = firstUse[index] + base;
+    }
+
+    MeshData::Submesh result{};
+    result.firstIndex = static_cast<uint32_t>(optimized.indices.size());
+    result.indexCount = static_cast<uint32_t>(indices.size());
+    result.firstVertex = base;
+    result.vertexCount = next;
+    optimized.indices.insert(optimized.indices.end(), indices.begin(), indices.end());
+    optimized.submeshes.push_back(result);
+  }
+
+  mesh = std::move(optimized);
+}
+
+void MeshOptimizer::optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2) return;
+
+  // Triangles adjacent to each vertex, in CSR form
+  std::vector<uint32_t> valence(vertexCount, 0);
+  for (uint32_t index : indices) valence[index]++;
+
+  std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+  for (uint32_t v = 0; v < vertexCount; ++v)
+    adjacencyStart[v + 1] = adjacencyStart[v] + valence[v];
+
+  std::vector<uint32_t> adjacency(indices.size());
+  std::vector<uint32_t> cursor(adjacencyStart.begin(), adjacencyStart.end() - 1);
+  for (size_t t = 0; t < triangleCount; ++t)
+    for (size_t k = 0; k < 3; ++k)
+      adjacency[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+
+  std::vector<int32_t> cachePosition(vertexCount, -1);
+  std::vector<float> vertexScores(vertexCount);
+  for (uint32_t v = 0; v < vertexCount; ++v)
+    vertexScores[v] = vertexScore(-1, valence[v]);
+
+  std::vector<float> triangleScores(triangleCount);
+  for (size_t t = 0; t < triangleCount; ++t)
+    triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                        vertexScores[indices[t * 3 + 2]];
+
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<uint32_t> output;
+  output.reserve(indices.size());
+
+  std::vector<uint32_t> cache, nextCache;
+  cache.reserve(CACHE_SIZE + 3);
+  nextCache.reserve(CACHE_SIZE + 3);
+
+  size_t scanCursor = 0;
+  uint32_t best = 0;
+  for (size_t t = 1; t < triangleCount; ++t)
+    if (triangleScores[t] > triangleScores[best]) best = static_cast<uint32_t>(t);
+
+  while (best != NONE) {
+    emitted[best] = true;
+    const uint32_t *triangle = &indices[best * 3];
+    output.insert(output.end(), triangle, triangle + 3);
+
+    // Emitted vertices move to the front, the rest shift back and may fall out
+    nextCache.clear();
+    for (size_t k = 0; k < 3; ++k) {
+      valence[triangle[k]]--;
+      if (std::find(nextCache.begin(), nextCache.end(), triangle[k]) == nextCache.end())
+        nextCache.push_back(triangle[k]);
+    }
+    for (uint32_t v : cache)
+      if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+        nextCache.push_back(v);
+
+    for (size_t i = 0; i < nextCache.size(); ++i) {
+      const uint32_t v = nextCache[i];
+      cachePosition[v] = i < CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+      vertexScores[v] = vertexScore(cachePosition[v], valence[v]);
+    }
+
+    // Rescore triangles touching the old and new cache, picking the best
+    best = NONE;
+    float bestScore = -1.f;
+    for (uint32_t v : nextCache) {
+      for (uint32_t a = adjacencyStart[v]; a < adjacencyStart[v + 1]; ++a) {
+        const uint32_t t = adjacency[a];
+        if (emitted[t]) continue;
+        const float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+        triangleScores[t] = score;
+        if (score > bestScore && cachePosition[v] >= 0) {
+          bestScore = score;
+          best = t;
+        }
+      }
+    }
+
+    if (nextCache.size() > CACHE_SIZE) nextCache.resize(CACHE_SIZE);
+    std::swap(cache, nextCache);
+
+    // The cache holds nothing useful, restart from the next unemitted triangle
+    if (best == NONE) {
+      while (scanCursor < triangleCount && emitted[scanCursor]) scanCursor++;
+      if (scanCursor < triangleCount) best = static_cast<uint32_t>(scanCursor);
+    }
+  }
+
+  std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices,
+                                     std::span<const MeshData::Vertex> vertices) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2) return;
+
+  // Clusters start wherever the cache order misses all three vertices, so
+  // moving them around costs almost nothing in cache efficiency
+  std::vector<uint32_t> clusterStarts;
+  std::vector<uint32_t> fifo(16, NONE);
+  size_t fifoHead = 0;
+  for (size_t t = 0; t < triangleCount; ++t) {
+    uint32_t misses = 0;
+    for (size_t k = 0; k < 3; ++k) {
+      const uint32_t v = indices[t * 3 + k];
+      if (std::find(fifo.begin(), fifo.end(), v) != fifo.end()) continue;
+      fifo[fifoHead] = v;
+      fifoHead = (fifoHead + 1) % fifo.size();
+      misses++;
+    }
+    if (misses == 3 || t == 0) clusterStarts.push_back(static_cast<uint32_t>(t));
+  }
+  if (clusterStarts.size() < 2) return;
+  clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+  glm::vec3 meshCentroid{0.f};
+  float meshArea = 0.f;
+
+  struct Cluster {
+    uint32_t first = 0, count = 0;
+    glm::vec3 centroid{0.f};
+    glm::vec3 normal{0.f};
+    float sortKey = 0.f;
+  };
+  std::vector<Cluster> clusters(clusterStarts.size() - 1);
+
+  for (size_t c = 0; c < clusters.size(); ++c) {
+    Cluster &cluster = clusters[c];
+    cluster.first = clusterStarts[c];
+    cluster.count = clusterStarts[c + 1] - clusterStarts[c];
+
+    float area = 0.f;
+    for (uint32_t t = cluster.first; t < cluster.first + cluster.count; ++t) {
+      const glm::vec3 &a = vertices[indices[t * 3]].position;
+      const glm::vec3 &b = vertices[indices[t * 3 + 1]].position;
+      const glm::vec3 &c2 = vertices[indices[t * 3 + 2]].position;
+      const glm::vec3 normal = glm::cross(b - a, c2 - a);
+      const float triangleArea = glm::length(normal);
+      cluster.centroid += (a + b + c2) * (triangleArea / 3.f);
+      cluster.normal += normal;
+      area += triangleArea;
+    }
+    meshCentroid += cluster.centroid;
+    meshArea += area;
+    cluster.centroid = area > 0.f ? cluster.centroid / area : glm::vec3{0.f};
+    const float length = glm::length(cluster.normal);
+    cluster.normal = length > 0.f ? cluster.normal / length : glm::vec3{0.f};
+  }
+  if (meshArea <= 0.f) return;
+  meshCentroid /= meshArea;
+
+  // Clusters facing away from the centre are likely to occlude the rest
+  for (Cluster &cluster : clusters)
+    cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal);
+  std::stable_sort(clusters.begin(), clusters.end(),
+                   [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+  std::vector<uint32_t> sorted;
+  sorted.reserve(indices.size());
+  for (const Cluster &cluster : clusters)
+    sorted.insert(sorted.end(), indices.begin() + cluster.first * 3,
+                  indices.begin() + (cluster.first + cluster.count) * 3);
+  std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+float MeshOptimizer::averageCacheMissRatio(std::span<const uint32_t> indices,
+                                           uint32_t vertexCount, uint32_t cacheSize) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) return 0.f;
+
+  // Timestamp FIFO: a vertex hits while it was inserted less than cacheSize misses ago
+  std::vector<uint32_t> insertedAt(vertexCount, 0);
+  uint32_t misses = 0;
+  for (uint32_t v : indices) {
+    if (insertedAt[v] == 0 || misses - insertedAt[v] >= cacheSize) {
+      misses++;
+      insertedAt[v] = misses;
+    }
+  }
+  return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+} // namespace Magma
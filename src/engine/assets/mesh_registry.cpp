@@ -0,0 +1,138 @@
+#include "mesh_registry.hpp"
+#include "core/device.hpp"
+#include "core/job_system.hpp"
+#include "core/upload_service.hpp"
+#include "mesh_cooker.hpp"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <print>
+
+namespace fs = std::filesystem;
+
+namespace Magma {
+
+MeshGeometry::~MeshGeometry() {
+  GeometryArena::free(vertexRange);
+  GeometryArena::free(indexRange);
+}
+
+MeshState MeshAsset::state() const {
+  if (state_ == MeshState::Uploading &&
+      Device::uploads().isComplete(geometry_->uploadValue))
+    return MeshState::Resident;
+  return state_;
+}
+
+MeshRegistry::MeshRegistry() { instance_ = this; }
+
+MeshRegistry::~MeshRegistry() { instance_ = nullptr; }
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+MeshHandle MeshRegistry::acquire(const std::string &path) {
+  const std::string key = fs::path{path}.lexically_normal().string();
+
+  if (auto asset = assetsByPath[key].lock();
+      asset && asset->state_ != MeshState::Failed)
+    return asset;
+
+  auto asset = std::make_shared<MeshAsset>();
+  asset->path_ = key;
+  assetsByPath[key] = asset;
+
+  auto job = std::make_shared<LoadJob>();
+  job->path = key;
+  pendingLoads.push_back({asset, job});
+
+  // Jobs must not throw; a load that does just leaves data null
+  JobSystem::get().submit([job]() {
+    try {
+      job->data = MeshCooker::load(job->path);
+    } catch (const std::exception &e) {
+      job->data.reset();
+      job->error = e.what();
+    } catch (...) {
+      job->data.reset();
+    }
+    job->done.store(true, std::memory_order_release);
+  });
+  return asset;
+}
+
+void MeshRegistry::update() {
+  std::erase_if(pendingLoads, [this](PendingLoad &load) {
+    if (!load.job->done.load(std::memory_order_acquire))
+      return false;
+
+    // Nobody wants the result anymore
+    std::shared_ptr<MeshAsset> asset = load.asset.lock();
+    if (!asset) return true;
+
+    std::unique_ptr<CookedMesh> data = std::move(load.job->data);
+    if (!data) {
+      if (load.job->error.empty())
+        std::println("Failed to load mesh: {}", load.job->path);
+      else
+        std::println("Failed to load mesh: {} ({})", load.job->path, load.job->error);
+      asset->state_ = MeshState::Failed;
+      return true;
+    }
+
+    asset->geometry_ = findGeometry(*data);
+    if (!asset->geometry_) {
+      const uint64_t hash = data->header().sourceHash;
+      asset->geometry_ = uploadGeometry(std::move(data));
+      geometryByHash[hash] = asset->geometry_;
+    }
+    asset->state_ = MeshState::Uploading;
+    return true;
+  });
+
+  std::erase_if(assetsByPath, [](const auto &entry) { return entry.second.expired(); });
+  std::erase_if(geometryByHash, [](const auto &entry) { return entry.second.expired(); });
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+std::shared_ptr<MeshGeometry> MeshRegistry::findGeometry(const CookedMesh &data) {
+  auto it = geometryByHash.find(data.header().sourceHash);
+  if (it == geometryByHash.end()) return nullptr;
+
+  std::shared_ptr<MeshGeometry> geometry = it->second.lock();
+  if (!geometry) return nullptr;
+
+  // Guard against hash collisions between unrelated sources
+  const CookedMeshHeader &header = geometry->data->header();
+  if (header.vertexCount != data.header().vertexCount ||
+      header.indexCount != data.header().indexCount)
+    return nullptr;
+  return geometry;
+}
+
+std::shared_ptr<MeshGeometry> MeshRegistry::uploadGeometry(std::unique_ptr<CookedMesh> data) {
+  GeometryArena &arena = GeometryArena::get();
+  const bool index16 = data->header().indexSize == sizeof(uint16_t);
+
+  auto geometry = std::make_shared<MeshGeometry>();
+  geometry->vertexRange = arena.allocate(
+      GeometryArena::vertexKind(data->vertexLayout()), data->vertexCount());
+  geometry->indexRange = arena.allocate(
+      index16 ? GeometryKind::Index16 : GeometryKind::Index, data->indexCount());
+
+  // Streams are already GPU-ready, they go straight into staging
+  if (geometry->vertexRange.valid())
+    arena.upload(geometry->vertexRange, data->vertexData().data());
+  if (geometry->indexRange.valid())
+    arena.upload(geometry->indexRange, data->indexData().data());
+
+  geometry->data = std::move(data);
+  geometry->uploadValue = Device::uploads().pendingValue();
+  return geometry;
+}
+
+} // namespace Magma
@@ -0,0 +1,99 @@
+#pragma once
+#include "core/cooked_mesh.hpp"
+#include "engine/render/geometry_arena.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Magma {
+
+enum class MeshState : uint8_t {
+  Empty,
+  Loading,   // cooking or mapping on a worker thread
+  Uploading, // waiting for the upload batch to complete
+  Resident,
+  Failed
+};
+
+/**
+ * The single CPU and GPU copy of a cooked mesh. Shared by every asset whose
+ * source has the same content, its arena ranges are freed with the last one.
+ */
+struct MeshGeometry {
+  std::unique_ptr<CookedMesh> data;
+  GeometryAllocation vertexRange;
+  GeometryAllocation indexRange;
+  uint64_t uploadValue = 0;
+
+  MeshGeometry() = default;
+  ~MeshGeometry();
+  MeshGeometry(const MeshGeometry &) = delete;
+  MeshGeometry &operator=(const MeshGeometry &) = delete;
+};
+
+/** Immutable mesh asset, shared through MeshHandle by every user of a path */
+class MeshAsset {
+public:
+  const std::string &path() const { return path_; }
+  MeshState state() const;
+  /** Null until the cooked data has been handed to the uploader */
+  const MeshGeometry *geometry() const { return geometry_.get(); }
+
+private:
+  friend class MeshRegistry;
+
+  std::string path_;
+  MeshState state_ = MeshState::Loading;
+  std::shared_ptr<MeshGeometry> geometry_;
+};
+
+using MeshHandle = std::shared_ptr<const MeshAsset>;
+
+/**
+ * Reference counted mesh assets keyed by path, with geometry deduplicated
+ * by the content hash of the cooked source. Assets are loaded once on the
+ * JobSystem and dropped when the last handle goes away.
+ * @note Owned by the RenderSystem; reachable through MeshRegistry::get()
+ */
+class MeshRegistry {
+public:
+  MeshRegistry();
+  ~MeshRegistry();
+
+  MeshRegistry(const MeshRegistry &) = delete;
+  MeshRegistry &operator=(const MeshRegistry &) = delete;
+
+  static MeshRegistry &get() { return *instance_; }
+
+  /** Returns the live asset for the path, or starts loading it */
+  MeshHandle acquire(const std::string &path);
+  /** Uploads finished loads and forgets expired entries, once per frame */
+  void update();
+
+private:
+  inline static MeshRegistry *instance_ = nullptr;
+
+  // Written by the worker, published with `done`
+  struct LoadJob {
+    std::string path;
+    std::unique_ptr<CookedMesh> data;
+    std::string error; // why data is null, when the load threw
+    std::atomic<bool> done{false};
+  };
+  struct PendingLoad {
+    std::weak_ptr<MeshAsset> asset;
+    std::shared_ptr<LoadJob> job;
+  };
+
+  std::unordered_map<std::string, std::weak_ptr<MeshAsset>> assetsByPath;
+  std::unordered_map<uint64_t, std::weak_ptr<MeshGeometry>> geometryByHash;
+  std::vector<PendingLoad> pendingLoads;
+
+  std::shared_ptr<MeshGeometry> findGeometry(const CookedMesh &data);
+  static std::shared_ptr<MeshGeometry> uploadGeometry(std::unique_ptr<CookedMesh> data);
+};
+
+} // namespace Magma
@@ -0,0 +1,313 @@
+#include "mesh_simplifier.hpp"
+#include "core/bounds.hpp"
+#include "core/hash.hpp"
+#include "mesh_optimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Magma {
+
+namespace {
+
+constexpr uint32_t NONE = ~0u;
+/** Largest collapse error as a fraction of the bounds diagonal */
+constexpr float MAX_RELATIVE_ERROR = 0.05f;
+/** Keeps open borders in place, relative to the faces next to them */
+constexpr double BORDER_WEIGHT = 10.0;
+
+/** Sum of squared distances to a set of weighted planes */
+struct Quadric {
+  double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+  double x = 0, y = 0, z = 0, c = 0;
+  double weight = 0;
+
+  static Quadric fromPlane(glm::vec3 normal, float distance, double weight) {
+    const double a = normal.x, b = normal.y, d = normal.z, e = distance;
+    Quadric q;
+    q.xx = weight * a * a; q.xy = weight * a * b; q.xz = weight * a * d;
+    q.yy = weight * b * b; q.yz = weight * b * d; q.zz = weight * d * d;
+    q.x = weight * a * e; q.y = weight * b * e; q.z = weight * d * e;
+    q.c = weight * e * e;
+    q.weight = weight;
+    return q;
+  }
+
+  void add(const Quadric &q) {
+    xx += q.xx; xy += q.xy; xz += q.xz; yy += q.yy; yz += q.yz; zz += q.zz;
+    x += q.x; y += q.y; z += q.z; c += q.c;
+    weight += q.weight;
+  }
+
+  /** Weighted mean squared distance of p to the planes */
+  double error(glm::vec3 p) const {
+    if (weight <= 0) return 0;
+    const double px = p.x, py = p.y, pz = p.z;
+    const double sum = xx * px * px + yy * py * py + zz * pz * pz +
+                       2 * (xy * px * py + xz * px * pz + yz * py * pz) +
+                       2 * (x * px + y * py + z * pz) + c;
+    return std::max(sum, 0.0) / weight;
+  }
+};
+
+struct Collapse {
+  double cost;
+  uint32_t from, to;
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+  return a < b ? (uint64_t{a} << 32) | b : (uint64_t{b} << 32) | a;
+}
+
+/** Maps every vertex to the first vertex sharing its position */
+std::vector<uint32_t> positionRemap(std::span<const MeshData::Vertex> vertices) {
+  size_t tableSize = 16;
+  while (tableSize < vertices.size() * 2) tableSize *= 2;
+
+  std::vector<uint32_t> table(tableSize, NONE);
+  std::vector<uint32_t> remap(vertices.size());
+  for (uint32_t v = 0; v < vertices.size(); ++v) {
+    const glm::vec3 &position = vertices[v].position;
+    size_t slot = hashBytes(&position, sizeof(position)) & (tableSize - 1);
+    while (table[slot] != NONE &&
+           std::memcmp(&vertices[table[slot]].position, &position, sizeof(position)) != 0)
+      slot = (slot + 1) & (tableSize - 1);
+
+    if (table[slot] == NONE) table[slot] = v;
+    remap[v] = table[slot];
+  }
+  return remap;
+}
+
+/** Triangles touching each position, in CSR form */
+void buildAdjacency(std::span<const uint32_t> indices, std::span<const uint32_t> canonical,
+                    std::vector<uint32_t> &start, std::vector<uint32_t> &triangles) {
+  start.assign(canonical.size() + 1, 0);
+  for (uint32_t index : indices) start[canonical[index] + 1]++;
+  for (size_t v = 0; v < canonical.size(); ++v) start[v + 1] += start[v];
+
+  std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+  triangles.resize(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    triangles[cursor[canonical[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void MeshSimplifier::generateLods(MeshData &mesh) {
+  mesh.lods.clear();
+  if (mesh.indices.empty()) return;
+  mesh.lods.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0.f});
+
+  const Bounds bounds = Bounds::fromVertices(mesh.vertices);
+  const float maxError = glm::length(bounds.max - bounds.min) * MAX_RELATIVE_ERROR;
+  const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+
+  // Each level simplifies the previous one, so errors add up along the chain
+  std::vector<uint32_t> current = mesh.indices;
+  while (mesh.lods.size() < MAX_LOD_COUNT) {
+    const size_t target = current.size() / 6 * 3;
+    if (target < MIN_LOD_TRIANGLES * 3) break;
+
+    float error = 0.f;
+    std::vector<uint32_t> lod = simplify(current, mesh.vertices, target, maxError, &error);
+    // Levels saving less than a quarter aren't worth their memory
+    if (lod.size() * 4 > current.size() * 3) break;
+
+    MeshOptimizer::optimizeVertexCache(lod, vertexCount);
+
+    MeshData::Lod range{};
+    range.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+    range.indexCount = static_cast<uint32_t>(lod.size());
+    range.error = mesh.lods.back().error + error;
+    mesh.indices.insert(mesh.indices.end(), lod.begin(), lod.end());
+    mesh.lods.push_back(range);
+    current = std::move(lod);
+  }
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(std::span<const uint32_t> indices,
+                                               std::span<const MeshData::Vertex> vertices,
+                                               size_t targetIndexCount, float maxError,
+                                               float *resultError) {
+  std::vector<uint32_t> result(indices.begin(), indices.end());
+  if (resultError) *resultError = 0.f;
+  if (result.size() <= targetIndexCount || vertices.empty()) return result;
+
+  // Collapses work on positions; vertices split for attribute seams move
+  // together and are then matched back up by attributes
+  const std::vector<uint32_t> canonical = positionRemap(vertices);
+  std::vector<uint32_t> wedgeStart(vertices.size() + 1, 0);
+  for (uint32_t v = 0; v < vertices.size(); ++v) wedgeStart[canonical[v] + 1]++;
+  for (size_t v = 0; v < vertices.size(); ++v) wedgeStart[v + 1] += wedgeStart[v];
+  std::vector<uint32_t> wedges(vertices.size());
+  {
+    std::vector<uint32_t> cursor(wedgeStart.begin(), wedgeStart.end() - 1);
+    for (uint32_t v = 0; v < vertices.size(); ++v) wedges[cursor[canonical[v]]++] = v;
+  }
+  auto position = [&](uint32_t v) { return vertices[v].position; };
+
+  // Quadrics of the input surface, plus planes perpendicular to open borders
+  std::vector<Quadric> quadrics(vertices.size());
+  std::vector<uint64_t> edges;
+  edges.reserve(result.size());
+  for (size_t i = 0; i < result.size(); i += 3)
+    for (size_t k = 0; k < 3; ++k)
+      edges.push_back(edgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]]));
+  std::sort(edges.begin(), edges.end());
+
+  for (size_t i = 0; i < result.size(); i += 3) {
+    const uint32_t a = canonical[result[i]], b = canonical[result[i + 1]],
+                   c = canonical[result[i + 2]];
+    const glm::vec3 normal = glm::cross(position(b) - position(a), position(c) - position(a));
+    const float length = glm::length(normal);
+    if (length <= 0.f) continue;
+
+    const glm::vec3 unit = normal / length;
+    const Quadric face = Quadric::fromPlane(unit, -glm::dot(unit, position(a)), length * 0.5);
+    quadrics[a].add(face);
+    quadrics[b].add(face);
+    quadrics[c].add(face);
+
+    const uint32_t corners[3] = {a, b, c};
+    for (size_t k = 0; k < 3; ++k) {
+      const uint32_t from = corners[k], to = corners[(k + 1) % 3];
+      const uint64_t key = edgeKey(from, to);
+      const auto range = std::equal_range(edges.begin(), edges.end(), key);
+      if (range.second - range.first != 1) continue;
+
+      const glm::vec3 edge = position(to) - position(from);
+      const glm::vec3 borderNormal = glm::cross(edge, unit);
+      const float borderLength = glm::length(borderNormal);
+      if (borderLength <= 0.f) continue;
+      const glm::vec3 borderUnit = borderNormal / borderLength;
+      const Quadric border = Quadric::fromPlane(
+          borderUnit, -glm::dot(borderUnit, position(from)),
+          glm::dot(edge, edge) * BORDER_WEIGHT);
+      quadrics[from].add(border);
+      quadrics[to].add(border);
+    }
+  }
+
+  const double maxCost = static_cast<double>(maxError) * maxError;
+  double worstCost = 0.0;
+  size_t indexCount = result.size();
+
+  std::vector<uint32_t> adjacencyStart, adjacency, collapseTo;
+  std::vector<Collapse> collapses;
+  std::vector<bool> locked;
+
+  // Each pass collapses the cheapest edges whose neighbourhoods don't
+  // overlap, then rebuilds the index list and ranks the new edges
+  while (indexCount > targetIndexCount) {
+    buildAdjacency(result, canonical, adjacencyStart, adjacency);
+
+    edges.clear();
+    for (size_t i = 0; i < result.size(); i += 3)
+      for (size_t k = 0; k < 3; ++k)
+        edges.push_back(edgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]]));
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    collapses.clear();
+    for (uint64_t key : edges) {
+      const uint32_t u = static_cast<uint32_t>(key >> 32), v = static_cast<uint32_t>(key);
+      if (u == v) continue;
+      Quadric q = quadrics[u];
+      q.add(quadrics[v]);
+      const double toV = q.error(position(v)), toU = q.error(position(u));
+      collapses.push_back(toV <= toU ? Collapse{toV, u, v} : Collapse{toU, v, u});
+    }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+    collapseTo.assign(vertices.size(), NONE);
+    locked.assign(vertices.size(), false);
+    size_t collapsed = 0;
+    for (const Collapse &collapse : collapses) {
+      if (collapse.cost > maxCost || indexCount <= targetIndexCount) break;
+      if (locked[collapse.from] || locked[collapse.to]) continue;
+
+      // Reject collapses that flip any surviving triangle
+      uint32_t removed = 0;
+      bool flips = false;
+      for (uint32_t a = adjacencyStart[collapse.from]; a < adjacencyStart[collapse.from + 1]; ++a) {
+        const uint32_t *triangle = &result[adjacency[a] * 3];
+        uint32_t corners[3];
+        bool touchesTarget = false;
+        for (size_t k = 0; k < 3; ++k) {
+          corners[k] = canonical[triangle[k]];
+          touchesTarget |= corners[k] == collapse.to;
+        }
+        if (touchesTarget) {
+          removed++;
+          continue;
+        }
+        const glm::vec3 before = glm::cross(position(corners[1]) - position(corners[0]),
+                                            position(corners[2]) - position(corners[0]));
+        for (uint32_t &corner : corners)
+          if (corner == collapse.from) corner = collapse.to;
+        const glm::vec3 after = glm::cross(position(corners[1]) - position(corners[0]),
+                                           position(corners[2]) - position(corners[0]));
+        if (glm::dot(before, after) <= 0.f) {
+          flips = true;
+          break;
+        }
+      }
+      if (flips) continue;
+
+      collapseTo[collapse.from] = collapse.to;
+      quadrics[collapse.to].add(quadrics[collapse.from]);
+      for (uint32_t a = adjacencyStart[collapse.from]; a < adjacencyStart[collapse.from + 1]; ++a)
+        for (size_t k = 0; k < 3; ++k)
+          locked[canonical[result[adjacency[a] * 3 + k]]] = true;
+
+      worstCost = std::max(worstCost, collapse.cost);
+      indexCount -= std::min<size_t>(indexCount, removed * 3);
+      collapsed++;
+    }
+    if (collapsed == 0) break;
+
+    // Moved vertices take the wedge at the target whose attributes match best
+    size_t write = 0;
+    for (size_t i = 0; i < result.size(); i += 3) {
+      uint32_t triangle[3];
+      for (size_t k = 0; k < 3; ++k) {
+        const uint32_t index = result[i + k];
+        const uint32_t target = collapseTo[canonical[index]];
+        triangle[k] = index;
+        if (target == NONE) continue;
+
+        float bestScore = std::numeric_limits<float>::lowest();
+        for (uint32_t w = wedgeStart[target]; w < wedgeStart[target + 1]; ++w) {
+          const MeshData::Vertex &candidate = vertices[wedges[w]];
+          const glm::vec3 color = candidate.color - vertices[index].color;
+          const float score = glm::dot(candidate.normal, vertices[index].normal) -
+                              glm::dot(color, color);
+          if (score > bestScore) {
+            bestScore = score;
+            triangle[k] = wedges[w];
+          }
+        }
+      }
+      const uint32_t a = canonical[triangle[0]], b = canonical[triangle[1]],
+                     c = canonical[triangle[2]];
+      if (a == b || b == c || a == c) continue;
+      result[write++] = triangle[0];
+      result[write++] = triangle[1];
+      result[write++] = triangle[2];
+    }
+    result.resize(write);
+    indexCount = result.size();
+  }
+
+  if (resultError) *resultError = static_cast<float>(std::sqrt(worstCost));
+  return result;
+}
+
+} // namespace Magma
@@ -0,0 +1,36 @@
+#pragma once
+#include "core/mesh_data.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Magma {
+
+/**
+ * Import-time level of detail generation, run by the MeshCooker after the
+ * MeshOptimizer. Levels are index buffers over the unchanged vertex stream,
+ * produced by quadric error edge collapse where a vertex collapses onto one
+ * of its neighbours, so no vertices are created.
+ */
+class MeshSimplifier {
+public:
+  static constexpr uint32_t MAX_LOD_COUNT = 6;
+  /** Levels stop once they would have fewer triangles than this */
+  static constexpr uint32_t MIN_LOD_TRIANGLES = 32;
+
+  /** Appends LOD index ranges to mesh.indices, each about half the last */
+  static void generateLods(MeshData &mesh);
+
+  /**
+   * Collapses edges of an indexed triangle list until it has at most
+   * targetIndexCount indices or every remaining collapse would deviate more
+   * than maxError from the input surface.
+   * @param resultError receives the largest deviation actually introduced
+   */
+  static std::vector<uint32_t> simplify(std::span<const uint32_t> indices,
+                                        std::span<const MeshData::Vertex> vertices,
+                                        size_t targetIndexCount, float maxError,
+                                        float *resultError = nullptr);
+};
+
+} // namespace Magma
@@ -0,0 +1,93 @@
+#pragma once
+#include "components/component.hpp"
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Magma {
+
+/** Type erased side of a ComponentPool, used where the type isn't known */
+class ComponentPoolBase {
+public:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  virtual ~ComponentPoolBase() = default;
+
+  bool contains(uint32_t slot) const { return slot < sparse.size() && sparse[slot] != NONE; }
+  uint32_t size() const { return static_cast<uint32_t>(slots.size()); }
+  /** Object slot of every component, in packed order */
+  std::span<const uint32_t> objectSlots() const { return slots; }
+
+  virtual Component *get(uint32_t slot) = 0;
+  virtual void remove(uint32_t slot) = 0;
+  /** Moves a detached component of the pool's type in */
+  virtual void adopt(uint32_t slot, std::unique_ptr<Component> component) = 0;
+  /** Moves a component out, to live on its detached GameObject */
+  virtual std::unique_ptr<Component> release(uint32_t slot) = 0;
+
+protected:
+  std::vector<uint32_t> slots;  // dense index -> object slot
+  std::vector<uint32_t> sparse; // object slot -> dense index
+};
+
+/**
+ * Sparse set storing every T of one Scene contiguously, indexed by the
+ * owning object's ObjectHandle slot. Removal moves the last component into
+ * the gap, so component pointers stay valid only until the next T is added
+ * to or removed from the scene.
+ */
+template <typename T>
+class ComponentPool final : public ComponentPoolBase {
+public:
+  T *find(uint32_t slot) { return contains(slot) ? &dense[sparse[slot]] : nullptr; }
+  std::span<T> components() { return dense; }
+
+  template <typename... Args>
+  T &emplace(uint32_t slot, Args &&...args) {
+    if (slot >= sparse.size()) sparse.resize(slot + 1, NONE);
+    assert(sparse[slot] == NONE && "Object already has a component of this type!");
+    sparse[slot] = static_cast<uint32_t>(dense.size());
+    slots.push_back(slot);
+    return dense.emplace_back(std::forward<Args>(args)...);
+  }
+
+  Component *get(uint32_t slot) override { return find(slot); }
+
+  void remove(uint32_t slot) override {
+    if (!contains(slot)) return;
+    const uint32_t index = sparse[slot];
+    const uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+    if (index != last) {
+      dense[index] = std::move(dense[last]);
+      slots[index] = slots[last];
+      sparse[slots[index]] = index;
+    }
+    dense.pop_back();
+    slots.pop_back();
+    sparse[slot] = NONE;
+  }
+
+  void adopt(uint32_t slot, std::unique_ptr<Component> component) override {
+    emplace(slot, std::move(static_cast<T &>(*component)));
+  }
+
+  std::unique_ptr<Component> release(uint32_t slot) override {
+    if (!contains(slot)) return nullptr;
+    auto component = std::make_unique<T>(std::move(dense[sparse[slot]]));
+    remove(slot);
+    return component;
+  }
+
+  /** Ticks components [begin, end) in packed order, calling T::onUpdate directly */
+  void update(uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) dense[i].T::onUpdate();
+  }
+
+private:
+  std::vector<T> dense;
+};
+
+} // namespace Magma
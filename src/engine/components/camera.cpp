@@ -1,6 +1,8 @@
 #include "camera.hpp"
+#include "core/frustum.hpp"
 #include "engine/gameobject.hpp"
 #include <format>
+#include <glm/geometric.hpp>
 #include <glm/trigonometric.hpp>
 #include <stdexcept>
 
@@ -38,7 +40,23 @@ void Camera::setView(const glm::vec3 &position, const glm::vec3 &rotation) {
   const glm::vec3 u{c1 * c3 + s1 * s2 * s3, c2 * s3, c1 * s2 * s3 - s1 * c3};
   const glm::vec3 v{s1 * s2 * c3 - s3 * c1, c2 * c3, s1 * s3 + c1 * s2 * c3};
   const glm::vec3 w{s1 * c2, -s2, c1 * c2};
+  setViewBasis(u, v, w, position);
+}
+
+void Camera::setView(const glm::mat4 &world) {
+  // The basis columns carry the scale of the object and its parents, and
+  // the shear of non-uniform parent scales; orthonormalize them from the
+  // forward axis, keeping a proper rotation even for mirroring scales
+  const glm::vec3 forward{world[2]};
+  const glm::vec3 upAxis{world[1]};
+  const glm::vec3 w = glm::normalize(forward);
+  const glm::vec3 v = glm::normalize(upAxis - glm::dot(upAxis, w) * w);
+  const glm::vec3 u = glm::cross(v, w);
+  setViewBasis(u, v, w, glm::vec3{world[3]});
+}
 
+void Camera::setViewBasis(const glm::vec3 &u, const glm::vec3 &v, const glm::vec3 &w,
+                          const glm::vec3 &position) {
   viewMatrix = glm::mat4{1.f};
   viewMatrix[0][0] = u.x; viewMatrix[1][0] = u.y; viewMatrix[2][0] = u.z;
   viewMatrix[0][1] = v.x; viewMatrix[1][1] = v.y; viewMatrix[2][1] = v.z;
@@ -65,43 +83,25 @@ void Camera::onUpdate() {
       std::format("No ownerTransform found in Camera Component: {}", (void*)transform)
     );
 
-  setView(transform->position, transform->rotation);
+  // Scene cameras run after transform propagation; detached ones, like the
+  // editor's, compose their own
+  if (!owner->scene) transform->updateDetached();
+  setView(transform->worldMatrix());
 }
 
 void Camera::collectProxy(RenderProxy &proxy) {
   CameraProxy cameraProxy = {};
   cameraProxy.projView = projectionMatrix * viewMatrix;
+  if (auto *transform = owner->getComponent<Transform>())
+    cameraProxy.position = transform->worldPosition();
+  cameraProxy.lodScale = projectionMatrix[1][1] * 0.5f;
   proxy.camera = cameraProxy;
 }
 
-/*
-bool Camera::canSee(const glm::vec3 &position) const {
-  AABB chunkBounds;
-  chunkBounds.min = position;
-  chunkBounds.max = position + glm::vec3{32.f, 32.f, 32.f};
-
-  std::array<glm::vec3, 8> corners = {
-    chunkBounds.min,
-    {chunkBounds.min.x, chunkBounds.min.y, chunkBounds.max.z},
-    {chunkBounds.min.x, chunkBounds.max.y, chunkBounds.min.z},
-    {chunkBounds.min.x, chunkBounds.max.y, chunkBounds.max.z},
-    {chunkBounds.max.x, chunkBounds.min.y, chunkBounds.min.z},
-    {chunkBounds.max.x, chunkBounds.min.y, chunkBounds.max.z},
-    {chunkBounds.max.x, chunkBounds.max.y, chunkBounds.min.z},
-    chunkBounds.max,
-  };
-
-  for (const auto &corner : corners) {
-    glm::vec4 clipSpace = projectionMatrix * viewMatrix * glm::vec4(corner, 1.f);
-    bool inFrustum = (-clipSpace.w < clipSpace.x && clipSpace.x < clipSpace.w &&
-                      -clipSpace.w < clipSpace.y && clipSpace.y < clipSpace.w &&
-                      0 < clipSpace.z && clipSpace.z < clipSpace.w);
-    if (inFrustum)
-      return true;
-  }
-  return false;
+bool Camera::canSee(const glm::vec3 &center, float radius) const {
+  return Frustum::fromMatrix(projectionMatrix * viewMatrix)
+      .intersects(center, glm::vec3{radius}, radius);
 }
-*/
 
 #if defined(MAGMA_WITH_EDITOR)
 void Camera::onInspector() {
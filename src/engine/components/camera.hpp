@@ -1,5 +1,6 @@
 #pragma once
 #include "component.hpp"
+#include "component_registry.hpp"
 #include "transform.hpp"
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
@@ -13,7 +14,7 @@ struct CameraUBO {
   glm::mat4 projectionView{1.f};
 };
 
-class Camera : public Component {
+class Camera final : public Component {
 public:
   Camera(GameObject *owner) : Component(owner) {}
 
@@ -24,9 +25,14 @@ public:
   const glm::mat4 &getProjection() const { return projectionMatrix; }
   const glm::mat4 &getView() const { return viewMatrix; }
   void setView(const glm::vec3 &position, const glm::vec3 &rotation);
+  /** View from a world matrix's position and orientation, ignoring its scale */
+  void setView(const glm::mat4 &world);
 
-  bool canSee(const glm::vec3 &position) const;
+  /** Whether a world space sphere touches the view frustum */
+  bool canSee(const glm::vec3 &center, float radius) const;
 
+  /** The view follows the owner's world Transform, so it updates after propagation */
+  using UpdateReads = TypeList<Transform>;
   void onUpdate() override;
   void collectProxy(RenderProxy &proxy) override;
 
@@ -46,6 +52,9 @@ private:
   void calculateProjectionMatrix();
 
   glm::mat4 viewMatrix{1.f};
+  /** View from an orthonormal camera basis and position */
+  void setViewBasis(const glm::vec3 &u, const glm::vec3 &v, const glm::vec3 &w,
+                    const glm::vec3 &position);
 };
 
 } // namespace Magma
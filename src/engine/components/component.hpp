@@ -1,6 +1,7 @@
 #pragma once
 #include "core/render_proxy.hpp"
 #include <cstdint>
+#include <type_traits>
 
 namespace Magma {
 class GameObject;
@@ -8,15 +9,21 @@ class GameObject;
 /**
  * Abstract class for all components.
  * Components are used to add functionality to entities.
+ * They are stored by value in their Scene's ComponentPools, so every
+ * component type must be movable.
  */
 class Component {
 public:
   Component(GameObject *owner): owner{owner} {}
   virtual ~Component() = default;
 
+  Component(Component &&) = default;
+  Component &operator=(Component &&) = default;
+
   // --- Lifecycle ---
   virtual void onAwake() {}
-  virtual void onUpdate() = 0;
+  /** Per frame tick; types that don't override it are never ticked */
+  virtual void onUpdate() {}
   virtual void collectProxy(RenderProxy &proxy) = 0;
 
   #if defined(MAGMA_WITH_EDITOR)
@@ -29,4 +36,9 @@ protected:
   GameObject *owner = nullptr;
 };
 
+/** Whether T declares its own onUpdate, rather than inheriting the empty one */
+template <typename T>
+inline constexpr bool overridesUpdate =
+    !std::is_same_v<decltype(&T::onUpdate), void (Component::*)()>;
+
 } // namespace Magma
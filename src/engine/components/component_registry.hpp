@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+namespace Magma {
+
+class Camera;
+class Mesh;
+class PointLight;
+class Transform;
+
+/** Compile time list of types, each identified by its position in the list */
+template <typename... Ts>
+struct TypeList {
+  static constexpr uint32_t COUNT = sizeof...(Ts);
+
+  /** Position of T in the list, COUNT if it isn't listed */
+  template <typename T>
+  static constexpr uint32_t indexOf() {
+    uint32_t index = 0;
+    ((std::is_same_v<T, Ts> ? false : (++index, true)) && ...);
+    return index;
+  }
+
+  /** Calls visit.template operator()<T>() for every type, in list order */
+  template <typename F>
+  static void forEach(F &&visit) {
+    (visit.template operator()<Ts>(), ...);
+  }
+};
+
+/** Every component type; a new component is registered by listing it here */
+using ComponentTypes = TypeList<Transform, Camera, Mesh, PointLight>;
+inline constexpr uint32_t COMPONENT_TYPE_COUNT = ComponentTypes::COUNT;
+
+template <typename T>
+struct ComponentId {
+  static constexpr uint32_t value = ComponentTypes::indexOf<T>();
+  static_assert(value < COMPONENT_TYPE_COUNT, "Component type is not listed in ComponentTypes");
+};
+
+/** Dense id of a component type, used to index pools without hashing */
+template <typename T>
+inline constexpr uint32_t componentId = ComponentId<T>::value;
+
+/** Set of component types as one bit per componentId */
+using ComponentMask = uint32_t;
+static_assert(COMPONENT_TYPE_COUNT <= 32, "ComponentMask holds one bit per component type");
+
+template <typename... Ts>
+inline constexpr ComponentMask componentMask = ((ComponentMask{1} << componentId<Ts>) | ... | 0u);
+
+/** componentMask of the types in a TypeList */
+template <typename List>
+inline constexpr ComponentMask listMask = 0;
+template <typename... Ts>
+inline constexpr ComponentMask listMask<TypeList<Ts...>> = componentMask<Ts...>;
+
+} // namespace Magma
@@ -1,20 +1,11 @@
 #include "mesh.hpp"
-#include "core/mesh_data.hpp"
-#include "core/device.hpp"
-#include "engine/scene.hpp"
-#include "engine/scene_action.hpp"
-#include "engine/scene_manager.hpp"
 #include <algorithm>
 #include <filesystem>
 #include <print>
 
-#define TINYGLTF3_IMPLEMENTATION
-#define TINYGLTF3_ENABLE_FS          // enable file I/O
-#define TINYGLTF3_ENABLE_STB_IMAGE   // enable image decoding
-#include "tiny_gltf.h"
-
 #if defined(MAGMA_WITH_EDITOR)
   #include "imgui.h"
+  #include "core/job_system.hpp"
   #include "core/window.hpp"
 #endif
 
@@ -36,26 +27,45 @@ inline bool hasAllowedExt(const fs::path &path) {
 }
 } // namespace string_utils
 
-Mesh::~Mesh() {
-  if (meshData) {
-    delete meshData;
-    meshData = nullptr;
-    vertexBuffer = nullptr;
-    indexBuffer = nullptr;
+void Mesh::onUpdate() {
+  if (!pendingAsset) return;
+
+  // The drawn asset is only swapped once the new one is resident
+  const MeshState pendingState = pendingAsset->state();
+  if (pendingState == MeshState::Failed) {
+    pendingAsset.reset();
+    state = MeshState::Failed;
+    return;
   }
+  state = pendingState;
+  if (pendingState == MeshState::Resident)
+    asset = std::move(pendingAsset);
 }
 
 void Mesh::collectProxy(RenderProxy &proxy) {
-  if (!meshData || !vertexBuffer)
+  const MeshGeometry *geometry = asset ? asset->geometry() : nullptr;
+  if (!geometry || !geometry->vertexRange.valid())
     return;
 
+  GeometryArena &arena = GeometryArena::get();
+  const GeometryAllocation &vertexRange = geometry->vertexRange;
+  const GeometryAllocation &indexRange = geometry->indexRange;
+  const bool hasIndexBuffer = indexRange.valid();
+
   MeshProxy meshProxy = {};
-  meshProxy.meshData = meshData;
-  meshProxy.vertexBuffer = vertexBuffer->getBuffer();
-  meshProxy.indexBuffer = hasIndexBuffer ? indexBuffer->getBuffer() : VK_NULL_HANDLE;
-  meshProxy.indexCount   = static_cast<uint32_t>(meshData->indices.size());
-  meshProxy.vertexCount  = static_cast<uint32_t>(meshData->vertices.size());
+  meshProxy.asset = geometry->data.get();
+  meshProxy.vertexBuffer = arena.getBuffer(vertexRange);
+  meshProxy.indexBuffer = hasIndexBuffer ? arena.getBuffer(indexRange) : VK_NULL_HANDLE;
+  // LOD 0; the extractor swaps in a coarser range from the chain
+  const auto lods = geometry->data->lods();
+  meshProxy.indexCount   = lods.empty() ? indexRange.count : lods.front().indexCount;
+  meshProxy.vertexCount  = vertexRange.count;
+  meshProxy.firstIndex   = indexRange.offset;
+  meshProxy.vertexOffset = static_cast<int32_t>(vertexRange.offset);
   meshProxy.hasIndexBuffer = hasIndexBuffer;
+  meshProxy.indexType = indexRange.kind == GeometryKind::Index16 ? VK_INDEX_TYPE_UINT16
+                                                                 : VK_INDEX_TYPE_UINT32;
+  meshProxy.vertexLayout = geometry->data->vertexLayout();
 
   proxy.mesh = meshProxy;
 }
@@ -71,96 +81,14 @@ bool Mesh::load() {
 #endif
 
 bool Mesh::load(const std::string &filepath) {
-  if (meshData) {
-    delete meshData;
-    meshData = nullptr;
-    vertexBuffer = nullptr;
-    indexBuffer = nullptr;
-  }
-
-  tg3_parse_options opts;
-  tg3_parse_options_init(&opts);
-  tg3_error_stack errors = {};                                                                                                              
-  tg3_model model = {};
-
-  tg3_error_code result = tg3_parse_file(&model, &errors,
-      filepath.c_str(), (uint32_t)filepath.size(), &opts);
-
-  if (result != TG3_OK) {
-    for (uint32_t i = 0; i < errors.count; i++) {
-      const tg3_error_entry *e = tg3_errors_get(&errors, i);
-      fprintf(stderr, "[%d] %s\n", (int)e->severity, e->message);
-    }
-    tg3_model_free(&model);
+  if (!fs::exists(filepath)) {
+    std::println("Mesh file not found: {}", filepath);
     return false;
   }
-  std::println("Loading glTF model: {}", filepath);
 
-  for (uint32_t mi = 0; mi < model.meshes_count; mi++) {
-    const tg3_mesh &mesh = model.meshes[mi];
-    for (uint32_t pi = 0; pi < mesh.primitives_count; pi++) {
-      const tg3_primitive &prim= mesh.primitives[pi];
-
-      int32_t posIdx = TG3_INDEX_NONE, normIdx = TG3_INDEX_NONE, uvIdx = TG3_INDEX_NONE, colorIdx = TG3_INDEX_NONE;
-      for (uint32_t ai = 0; ai < prim.attributes_count; ai++) {
-        const tg3_str &key = prim.attributes[ai].key;
-        if (strncmp(key.data, "POSITION",    key.len) == 0) 
-          posIdx = prim.attributes[ai].value;
-        if (strncmp(key.data, "NORMAL",      key.len) == 0) 
-          normIdx = prim.attributes[ai].value;
-        if (strncmp(key.data, "TEXCOORD_0",  key.len) == 0) 
-          uvIdx = prim.attributes[ai].value;
-        if (strncmp(key.data, "COLOR_0",  key.len) == 0) 
-          colorIdx = prim.attributes[ai].value;
-      }
-
-      if (posIdx == TG3_INDEX_NONE || normIdx == TG3_INDEX_NONE)
-        continue;
-
-      const tg3_accessor &posAcc  = model.accessors[posIdx];
-      const tg3_buffer_view &posBV  = model.buffer_views[posAcc.buffer_view];
-      const float *vertexData = reinterpret_cast<const float *>(
-        model.buffers[posBV.buffer].data.data + 
-        posBV.byte_offset + posAcc.byte_offset);
-
-      const tg3_accessor &normAcc = model.accessors[normIdx];
-      const tg3_buffer_view &normBV = model.buffer_views[normAcc.buffer_view];
-      const float *normalData = reinterpret_cast<const float *>(
-        model.buffers[normBV.buffer].data.data +
-        normBV.byte_offset + normAcc.byte_offset);
-
-      bool hasColor = colorIdx != TG3_INDEX_NONE;
-      const float* colorData = nullptr;
-      if (hasColor) {
-        const tg3_accessor &colorAcc = model.accessors[colorIdx];
-        const tg3_buffer_view &colorBV = model.buffer_views[colorAcc.buffer_view];
-        colorData = reinterpret_cast<const float*>(
-          model.buffers[colorBV.buffer].data.data +
-          colorBV.byte_offset + colorAcc.byte_offset);
-      }
-
-      meshData = new MeshData();
-      for (uint64_t i = 0; i < posAcc.count; i++) {
-        MeshData::Vertex vertex;
-        vertex.position = {vertexData[i*3], vertexData[i*3+1], vertexData[i*3+2]};
-        vertex.normal   = {normalData[i*3], normalData[i*3+1], normalData[i*3+2]};
-        vertex.color    = {colorData[i*3], colorData[i*3+1], colorData[i*3+2]};
-        meshData->vertices.push_back(vertex);
-      }
-
-      if (prim.indices != TG3_INDEX_NONE) {
-        const tg3_accessor   &idxAcc = model.accessors[prim.indices];
-        const tg3_buffer_view &idxBV  = model.buffer_views[idxAcc.buffer_view];
-        const uint32_t *indexData = reinterpret_cast<const uint32_t *>(
-            model.buffers[idxBV.buffer].data.data + idxBV.byte_offset + idxAcc.byte_offset);
-        for (uint64_t i = 0; i < idxAcc.count; i++)
-          meshData->indices.push_back(indexData[i]);
-      }
-    }
-  }
-  tg3_model_free(&model);
-  createVertexBuffer();
-  createIndexBuffer();
+  // A newer request supersedes one still loading
+  pendingAsset = MeshRegistry::get().acquire(filepath);
+  state = pendingAsset->state();
 
   #if defined(MAGMA_WITH_EDITOR)
     sourcePath = filepath;
@@ -169,55 +97,30 @@ bool Mesh::load(const std::string &filepath) {
   return true;
 }
 
-void Mesh::createVertexBuffer() {
-  assert(meshData != nullptr && "Cannot create vertex buffer before loading mesh data!");
-
-  uint32_t vertexCount = static_cast<uint32_t>(meshData->vertices.size());
-  uint32_t vertexSize  = sizeof(meshData->vertices[0]);
-
-  Buffer stagingBuffer(vertexSize, vertexCount,
-                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-  stagingBuffer.map();
-  stagingBuffer.writeToBuffer((void *)meshData->vertices.data());
-
-  vertexBuffer = std::make_unique<Buffer>(vertexSize, vertexCount,
-                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  Device::get().copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), vertexSize * vertexCount);
-}
-
-void Mesh::createIndexBuffer() {
-  assert(meshData != nullptr && "Cannot create index buffer before loading mesh data!");
-
-  uint32_t indexCount = static_cast<uint32_t>(meshData->indices.size());
-  hasIndexBuffer = indexCount > 0;
-  if (!hasIndexBuffer) return;
-
-  uint32_t indexSize = sizeof(meshData->indices[0]);
-
-  Buffer stagingBuffer(indexSize, indexCount,
-                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-  stagingBuffer.map();
-  stagingBuffer.writeToBuffer((void *)meshData->indices.data());
-
-  indexBuffer = std::make_unique<Buffer>(indexSize, indexCount,
-                                        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  Device::get().copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), indexSize * indexCount);
-}
-
 #if defined(MAGMA_WITH_EDITOR)
 void Mesh::onInspector() {
-  if (meshData) {
-    ImGui::Text("Vertices: %zu", meshData->vertices.size());
-    ImGui::Text("Indices: %zu", meshData->indices.size());
+  if (const MeshGeometry *geometry = asset ? asset->geometry() : nullptr) {
+    const VertexLayout layout = geometry->data->vertexLayout();
+    ImGui::Text("Vertices: %u", geometry->data->vertexCount());
+    ImGui::Text("Layout: %s (%u B)", VertexLayouts::name(layout), VertexLayouts::stride(layout));
+    const auto lods = geometry->data->lods();
+    ImGui::Text("Triangles: %u", lods.empty() ? 0u : lods.front().indexCount / 3);
+    for (size_t lod = 1; lod < lods.size(); ++lod)
+      ImGui::Text("  LOD %zu: %u (error %.4f)", lod, lods[lod].indexCount / 3, lods[lod].error);
+    ImGui::Text("Shared by: %ld", asset.use_count());
   }
+  if (state == MeshState::Loading || state == MeshState::Uploading)
+    ImGui::TextDisabled("Loading...");
+  else if (state == MeshState::Failed)
+    ImGui::TextDisabled("Failed to load");
 
+  // Listed in the background, the asset fields accept paths once it's done
   if (!assetsScanned) {
-    scanAssetsOnce();
     assetsScanned = true;
+    JobSystem::get().submit([] {
+      scanAssetsOnce();
+      assetsReady.store(true, std::memory_order_release);
+    });
   }
 
   if (pathBuffer[0] == 0 && !sourcePath.empty())
@@ -232,18 +135,16 @@ void Mesh::onInspector() {
   if (ImGui::IsItemHovered() && Window::hasDroppedText) {
     std::string dropped = Window::getDroppedText();
     snprintf(pathBuffer, sizeof(pathBuffer), "%s", dropped.c_str());
-    if (std::find(assets.begin(), assets.end(), dropped) != assets.end()) {
-      sourcePath = dropped;
-      SceneManager::activeScene->defer(SceneAction::loadMesh(this));
+    if (isKnownAsset(dropped)) {
+      load(dropped);
     }
     Window::resetHasDropped();
   }
 
   if (pressedEnter) {
     std::string typed = pathBuffer;
-    if (std::find(assets.begin(), assets.end(), typed) != assets.end()) {
-      sourcePath = typed;
-      SceneManager::activeScene->defer(SceneAction::loadMesh(this));
+    if (isKnownAsset(typed)) {
+      load(typed);
     }
   }
 
@@ -269,6 +170,11 @@ void Mesh::scanAssetsOnce() {
   std::sort(assets.begin(), assets.end());
   assets.erase(std::unique(assets.begin(), assets.end()), assets.end());
 }
+
+bool Mesh::isKnownAsset(const std::string &path) {
+  return assetsReady.load(std::memory_order_acquire) &&
+         std::binary_search(assets.begin(), assets.end(), path);
+}
 #endif
 
 } // namespace Magma
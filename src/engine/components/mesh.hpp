@@ -1,25 +1,31 @@
 #pragma once
 #include "component.hpp"
-#include "core/buffer.hpp"
+#include "engine/assets/mesh_registry.hpp"
 #include "engine/gameobject.hpp"
-#include <memory>
+#include <atomic>
 #include <string>
 #include <vector>
 
 namespace Magma {
 
-class Device;
-class MeshData;
-
-class Mesh : public Component {
+/**
+ * Renders glTF geometry out of the shared GeometryArena.
+ * Loading happens on the JobSystem through the MeshCooker, so warm loads
+ * only map the cached `.magmamesh` file; until the new geometry is resident the
+ * mesh keeps drawing what it had before, or nothing.
+ */
+class Mesh final : public Component {
 public:
   Mesh(GameObject* owner): Component(owner) {}
-  ~Mesh();
 
   bool load();
+  /** Starts loading in the background, false if the file doesn't exist */
   bool load(const std::string &filepath);
+  MeshState getState() const { return state; }
 
-  void onUpdate() override {}
+  /** Swapping assets may free GeometryArena ranges, which isn't thread safe */
+  static constexpr bool UPDATE_ON_MAIN_THREAD = true;
+  void onUpdate() override;
   void collectProxy(RenderProxy &proxy) override;
 
   #if defined(MAGMA_WITH_EDITOR)
@@ -29,13 +35,10 @@ public:
   #endif
 
 private:
-  MeshData *meshData = nullptr;
+  MeshState state = MeshState::Empty;
 
-  std::unique_ptr<Buffer> vertexBuffer;
-  std::unique_ptr<Buffer> indexBuffer;
-  bool hasIndexBuffer = false;
-  void createVertexBuffer();
-  void createIndexBuffer();
+  MeshHandle asset;        // drawn
+  MeshHandle pendingAsset; // replaces asset once resident
 
   #if defined(MAGMA_WITH_EDITOR)
     std::string sourcePath;
@@ -43,9 +46,12 @@ private:
     int popupSelection = -1;
     std::vector<std::string> filteredAssets;
 
+    // Filled by a scan job, published through assetsReady
     inline static std::vector<std::string> assets;
+    inline static std::atomic<bool> assetsReady = false;
     inline static bool assetsScanned = false;
     static void scanAssetsOnce();
+    static bool isKnownAsset(const std::string &path);
   #endif
 };
 
@@ -7,13 +7,11 @@
 
 namespace Magma {
 
-void PointLight::onUpdate() {
-  auto *transform = owner->getComponent<Transform>();
-  if (transform)
-    lightData.position = {transform->position, 0.f};
-}
-
 void PointLight::collectProxy(RenderProxy &proxy) {
+  // Proxies are collected after world transforms are composed
+  if (auto *transform = owner->getComponent<Transform>())
+    lightData.position = {transform->worldPosition(), 0.f};
+
   PointLightProxy plProxy = {};
   plProxy.position = lightData.position;
   plProxy.color = lightData.color;
@@ -15,11 +15,10 @@ struct PointLightSSBO {
   alignas(16) PointLightData lights[128] = {};
 };
 
-class PointLight : public Component {
+class PointLight final : public Component {
 public:
   PointLight(GameObject *owner) : Component(owner) {}
 
-  void onUpdate() override;
   void collectProxy(RenderProxy &proxy) override;
 
   #if defined(MAGMA_WITH_EDITOR)
@@ -1,6 +1,6 @@
 #include "transform.hpp"
+#include "core/transform_kernel.hpp"
 #include "engine/gameobject.hpp"
-#include <glm/trigonometric.hpp>
 
 #if defined(MAGMA_WITH_EDITOR)
   #include "imgui.h"
@@ -8,11 +8,65 @@
 
 namespace Magma {
 
+namespace {
+/** A single transform as one-lane kernel streams */
+TransformStreams localStreams(const glm::vec3 &position, const glm::vec3 &rotation,
+                              const glm::vec3 &scale) {
+  return {&position.x, &position.y, &position.z,
+          &rotation.x, &rotation.y, &rotation.z,
+          &scale.x,    &scale.y,    &scale.z};
+}
+} // namespace
+
+bool Transform::syncLocal() {
+  if (version != 0 && position == cachedPosition && rotation == cachedRotation &&
+      scale == cachedScale)
+    return false;
+  cachedPosition = position;
+  cachedRotation = rotation;
+  cachedScale = scale;
+  return true;
+}
+
+void Transform::setLocalMatrices(const glm::mat4 &model, const glm::mat3x4 &normal) {
+  cachedModel = model;
+  cachedNormal = normal;
+}
+
+bool Transform::updateWorld(const Transform *parent, bool parentChanged, bool localChanged) {
+  // Reparenting, or an ancestor gaining or losing its Transform, changes
+  // the parent without changing any matrix
+  if (parent != cachedParent) {
+    cachedParent = parent;
+    parentChanged = true;
+  }
+  if (!localChanged && !parentChanged) return false;
+
+  // Inverse transposes compose in the same order as the matrices themselves
+  cachedWorld = parent ? parent->cachedWorld * cachedModel : cachedModel;
+  cachedWorldNormal = parent ? glm::mat3x4{glm::mat3{parent->cachedWorldNormal} *
+                                           glm::mat3{cachedNormal}}
+                             : cachedNormal;
+  version++;
+  return true;
+}
+
+void Transform::updateDetached() {
+  if (!syncLocal()) return;
+  TransformKernel::compose(localStreams(cachedPosition, cachedRotation, cachedScale), 1,
+                           &cachedModel, &cachedNormal);
+  updateWorld(nullptr, false, true);
+}
+
 void Transform::collectProxy(RenderProxy &proxy) {
+  // Objects outside the scene hierarchy are never composed by the extractor
+  if (version == 0) updateDetached();
+
   TransformProxy transformProxy = {};
-  transformProxy.modelMatrix = modelMatrix();
-  transformProxy.normalMatrix = normalMatrix();
+  transformProxy.modelMatrix = cachedWorld;
+  transformProxy.normalMatrix = cachedWorldNormal;
   transformProxy.objectId = owner->id;
+  transformProxy.version = version;
 
   proxy.transform = transformProxy;
 }
@@ -27,64 +81,33 @@ void Transform::onInspector() {
 
 // Direction vectors
 glm::vec3 Transform::forward() const {
-  const float c1 = glm::cos(rotation.y);
-  const float s1 = glm::sin(rotation.y);
-  const float c2 = glm::cos(rotation.x);
-  const float s2 = glm::sin(rotation.x);
+  float s1, c1, s2, c2;
+  TransformKernel::sincos(rotation.y, s1, c1);
+  TransformKernel::sincos(rotation.x, s2, c2);
   return glm::vec3{s1 * c2, -s2, c1 * c2};
 }
 
 glm::vec3 Transform::right() const {
-  const float c1 = glm::cos(rotation.y);
-  const float s1 = glm::sin(rotation.y);
-  const float c2 = glm::cos(rotation.x);
-  const float s2 = glm::sin(rotation.x);
-  const float c3 = glm::cos(rotation.z);
-  const float s3 = glm::sin(rotation.z);
+  float s1, c1, s2, c2, s3, c3;
+  TransformKernel::sincos(rotation.y, s1, c1);
+  TransformKernel::sincos(rotation.x, s2, c2);
+  TransformKernel::sincos(rotation.z, s3, c3);
   return glm::vec3{c1 * c3 + s1 * s2 * s3, c2 * s3, c1 * s2 * s3 - s1 * c3};
 }
 
 glm::vec3 Transform::up() const {
-  const float c1 = glm::cos(rotation.y);
-  const float s1 = glm::sin(rotation.y);
-  const float c2 = glm::cos(rotation.x);
-  const float s2 = glm::sin(rotation.x);
-  const float c3 = glm::cos(rotation.z);
-  const float s3 = glm::sin(rotation.z);
+  float s1, c1, s2, c2, s3, c3;
+  TransformKernel::sincos(rotation.y, s1, c1);
+  TransformKernel::sincos(rotation.x, s2, c2);
+  TransformKernel::sincos(rotation.z, s3, c3);
   return glm::vec3{s1 * s2 * c3 - s3 * c1, c2 * c3, s1 * s3 + c1 * s2 * c3};
 }
 
 glm::mat4 Transform::modelMatrix() const {
-  const float c1 = glm::cos(rotation.y);
-  const float s1 = glm::sin(rotation.y);
-  const float c2 = glm::cos(rotation.x);
-  const float s2 = glm::sin(rotation.x);
-  const float c3 = glm::cos(rotation.z);
-  const float s3 = glm::sin(rotation.z);
-  return glm::mat4{
-      {scale.x * (c1 * c3 + s1 * s2 * s3), scale.x * c2 * s3,
-       scale.x * (c1 * s2 * s3 - s1 * c3), 0.f},
-      {scale.y * (s1 * s2 * c3 - s3 * c1), scale.y * c2 * c3,
-       scale.y * (s1 * s3 + c1 * s2 * c3), 0.f},
-      {scale.z * s1 * c2, scale.z * -s2, scale.z * c1 * c2, 0.f},
-      {position.x, position.y, position.z, 1.f}};
-}
-
-glm::mat4 Transform::normalMatrix() const {
-  const float c1 = glm::cos(rotation.y);
-  const float s1 = glm::sin(rotation.y);
-  const float c2 = glm::cos(rotation.x);
-  const float s2 = glm::sin(rotation.x);
-  const float c3 = glm::cos(rotation.z);
-  const float s3 = glm::sin(rotation.z);
-  const glm::vec3 invScale = 1.f / scale;
-  return glm::mat4{
-      {invScale.x * (c1 * c3 + s1 * s2 * s3), invScale.x * c2 * s3,
-       invScale.x * (c1 * s2 * s3 - s1 * c3), 0.f},
-      {invScale.y * (s1 * s2 * c3 - s3 * c1), invScale.y * c2 * c3,
-       invScale.y * (s1 * s3 + c1 * s2 * c3), 0.f},
-      {invScale.z * s1 * c2, invScale.z * -s2, invScale.z * c1 * c2, 0.f},
-      {0.f, 0.f, 0.f, 1.f}};
+  glm::mat4 model;
+  glm::mat3x4 normal;
+  TransformKernel::compose(localStreams(position, rotation, scale), 1, &model, &normal);
+  return model;
 }
 
 } // namespace Magma
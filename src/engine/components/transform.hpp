@@ -1,21 +1,22 @@
 #pragma once
 #include "component.hpp"
+#include <cstdint>
 #include <glm/fwd.hpp>
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
 namespace Magma {
 class GameObject;
 
-class Transform : public Component {
+class Transform final : public Component {
 public:
   Transform(GameObject* owner) : Component(owner) {}
-  ~Transform() = default;
 
   glm::vec3 position{0.0f, 0.0f, 0.0f};
   glm::vec3 rotation{0.0f, 0.0f, 0.0f};
   glm::vec3 scale{1.0f, 1.0f, 1.0f};
 
-  void onUpdate() override {}
   void collectProxy(RenderProxy &proxy) override;
 
   #if defined(MAGMA_WITH_EDITOR)
@@ -29,10 +30,43 @@ public:
   glm::vec3 right() const;
   glm::vec3 up() const;
 
+  /** Local matrix, relative to the closest ancestor with a Transform */
   glm::mat4 modelMatrix() const;
 
+  /**
+   * Records position/rotation/scale and returns whether they changed since
+   * the last call. TransformSystem::composeLocal then rebuilds the local
+   * matrices of the changed Transforms, one TransformKernel batch per chunk.
+   */
+  bool syncLocal();
+  void setLocalMatrices(const glm::mat4 &model, const glm::mat3x4 &normal);
+
+  /**
+   * Composes the parent's world matrices with the local ones if either
+   * changed, or if the parent is another Transform than last time. Returns
+   * whether the world matrices changed, which makes the children recompute
+   * theirs in turn.
+   */
+  bool updateWorld(const Transform *parent, bool parentChanged, bool localChanged);
+  /** Rebuilds the matrices of a Transform outside any scene, if it changed */
+  void updateDetached();
+
+  const glm::mat4 &worldMatrix() const { return cachedWorld; }
+  const glm::mat3x4 &worldNormalMatrix() const { return cachedWorldNormal; }
+  glm::vec3 worldPosition() const { return glm::vec3{cachedWorld[3]}; }
+
 private:
-  glm::mat4 normalMatrix() const;
+  // Matrices are rebuilt only when position/rotation/scale or the parent
+  // change; version lets the GPU object table skip unchanged transforms.
+  glm::vec3 cachedPosition{0.0f};
+  glm::vec3 cachedRotation{0.0f};
+  glm::vec3 cachedScale{1.0f};
+  glm::mat4 cachedModel{1.f};
+  glm::mat3x4 cachedNormal{1.f};
+  glm::mat4 cachedWorld{1.f};
+  glm::mat3x4 cachedWorldNormal{1.f};
+  const Transform *cachedParent = nullptr; // composed into cachedWorld
+  uint32_t version = 0;
 };
 
 } // namespace Magma
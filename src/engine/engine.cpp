@@ -14,12 +14,13 @@
 
 namespace Magma {
 
-Engine::Engine(Window &window) : window(&window) {
+Engine::Engine(Window &window, const JobSystemSpecification &jobSpec) : window(&window) {
+  jobSystem = std::make_unique<JobSystem>(jobSpec);
   renderSystem = std::make_unique<RenderSystem>(window);
 
   project = ProjectCreator::initProject();
   SceneManager::activeScene = project.scene;
-  SceneManager::activeScene->activeCamera = project.camera;
+  SceneManager::activeScene->activeCamera = project.camera->handle;
 
   std::println("Engine initialized successfully.");
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "core/render_system.hpp"
+#include "core/job_system.hpp"
 #include "core/window.hpp"
 #include "engine/project.hpp"
 #include "engine/render/imgui_renderer.hpp"
@@ -14,7 +15,7 @@ namespace Magma {
  */
 class Engine {
 public:
-  Engine(Window &window);
+  Engine(Window &window, const JobSystemSpecification &jobSpec = {});
 
   #if defined(MAGMA_WITH_EDITOR)
     void setImGuiRenderer(std::unique_ptr<ImGuiRenderer> renderer);
@@ -32,6 +33,8 @@ public:
 
 private:
   Window *window = nullptr;
+  // Declared first so workers outlive every system that submits to them
+  std::unique_ptr<JobSystem> jobSystem = nullptr;
   std::unique_ptr<RenderSystem> renderSystem = nullptr;
   Project project;
 
@@ -1,6 +1,7 @@
 #include "gameobject.hpp"
 #include "components/camera.hpp"
 #include "components/transform.hpp"
+#include "scene.hpp"
 #include <algorithm>
 #include <memory>
 
@@ -21,15 +22,16 @@ std::vector<GameObject *> GameObject::getChildren() {
   return result;
 }
 
-void GameObject::addChild() {
-  std::unique_ptr<GameObject> child(this);
-  children.push_back(std::move(child));
+GameObject *GameObject::addChild() {
+  return addChild(std::make_unique<GameObject>(this));
 }
 
-void GameObject::addChild(std::unique_ptr<GameObject> child) {
-  if (!child) return;
+GameObject *GameObject::addChild(std::unique_ptr<GameObject> child) {
+  if (!child) return nullptr;
   child->parent = this;
   children.push_back(std::move(child));
+  if (scene) scene->track(children.back().get());
+  return children.back().get();
 }
 
 void GameObject::removeChild(GameObject *child) {
@@ -37,6 +39,7 @@ void GameObject::removeChild(GameObject *child) {
   auto it = std::remove_if(children.begin(), children.end(),
                            [&](const auto &c) { return c.get() == child; });
   if (it == children.end()) return;
+  if (scene) scene->untrack(child);
   children.erase(it, children.end());
 }
 
@@ -72,19 +75,39 @@ void GameObject::drawChildren() {
 }
 #endif
 
-void GameObject::onUpdate() {
-  for (const auto &[type, component] : components) {
-    if (component) component->onUpdate();
+ComponentPoolBase *GameObject::scenePool(uint32_t typeId) const {
+  return scene->findPool(typeId);
+}
+
+std::vector<Component *> GameObject::getComponents() const {
+  std::vector<Component *> vec;
+  if (scene) {
+    scene->forEachComponent(handle, [&](Component &component) { vec.push_back(&component); });
+  } else {
+    for (const auto &component : components)
+      if (component) vec.push_back(component.get());
   }
-  for (const auto &child : children) {
-    if (child) child->onUpdate();
+  util::sortComponentsByName(vec);
+  return vec;
+}
+
+void GameObject::onUpdate() {
+  if (scene) {
+    scene->forEachComponent(handle, [](Component &component) { component.onUpdate(); });
+    return;
   }
+  for (const auto &component : components)
+    if (component) component->onUpdate();
 }
 
 RenderProxy GameObject::collectProxies() const {
   RenderProxy proxy = {};
-  for (auto &[type, component] : components)
-    component->collectProxy(proxy);
+  if (scene) {
+    scene->forEachComponent(handle, [&](Component &component) { component.collectProxy(proxy); });
+    return proxy;
+  }
+  for (const auto &component : components)
+    if (component) component->collectProxy(proxy);
   return proxy;
 }
 
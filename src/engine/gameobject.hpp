@@ -1,19 +1,23 @@
 #pragma once
+#include "component_pool.hpp"
 #include "components/component.hpp"
+#include "components/component_registry.hpp"
 #include "components/transform.hpp"
+#include "object_handle.hpp"
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <print>
 #include <string>
-#include <typeindex>
-#include <unordered_map>
 #include <vector>
 
 namespace Magma {
 
+class Scene;
+
 namespace util {
 inline void sortComponentsByName(std::vector<Component *> &components) {
   #if defined(MAGMA_WITH_EDITOR)
@@ -27,6 +31,8 @@ inline void sortComponentsByName(std::vector<Component *> &components) {
 
 /**
  * Entity in the scene that can have multiple components and children.
+ * While tracked by a Scene its components live in the scene's packed
+ * ComponentPools; detached objects keep them on the object itself.
  */
 class GameObject {
 public:
@@ -38,7 +44,7 @@ public:
   GameObject(GameObject *parent, std::string name) : id{getNextId()}, parent{parent}, name{name} {}
 
   ~GameObject() {
-    components.clear();
+    components = {};
     children.clear();
   }
 
@@ -49,8 +55,14 @@ public:
 
   // Children
   std::vector<GameObject *> getChildren();
-  void addChild();
-  void addChild(std::unique_ptr<GameObject> child);
+  /** Visits direct children without building a vector */
+  template <typename F>
+  void forEachChild(F &&visit) const {
+    for (const auto &child : children)
+      if (child) visit(child.get());
+  }
+  GameObject *addChild();
+  GameObject *addChild(std::unique_ptr<GameObject> child);
   void removeChild(GameObject *child);
   bool hasChildren() const { return !children.empty(); }
 
@@ -63,6 +75,7 @@ public:
     void drawChildren();
   #endif
 
+  /** Ticks this object's components; the SceneExtractor walks the children */
   void onUpdate();
 
   // Movement helpers used by editor input
@@ -82,30 +95,29 @@ public:
   template <typename T>
   T *getComponent() const {
     static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
-    auto it = components.find(typeid(T));
-    if (it != components.end())
-      return static_cast<T *>(it->second.get());
-    return nullptr;
+    if (scene)
+      return static_cast<ComponentPool<T> *>(scenePool(componentId<T>))->find(handle.index);
+    return static_cast<T *>(components[componentId<T>].get());
   }
 
-  std::vector<Component *> getComponents() const {
-    std::vector<Component *> vec;
-    for (auto &[type, comp] : components)
-      vec.push_back(comp.get());
-    util::sortComponentsByName(vec);
-    return vec;
-  }
+  std::vector<Component *> getComponents() const;
 
   template <typename T, typename... Args>
   T *addComponent(Args &&...args) {
     static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
 
+    if (scene) {
+      auto *pool = static_cast<ComponentPool<T> *>(scenePool(componentId<T>));
+      pool->remove(handle.index);
+      return &pool->emplace(handle.index, std::forward<Args>(args)..., this);
+    }
+
     std::unique_ptr<T> component = nullptr;
     component = std::make_unique<T>(std::forward<Args>(args)..., this);
     assert(component && "Failed to create component.");
 
     T *ptr = component.get();
-    components[typeid(T)] = std::move(component);
+    components[componentId<T>] = std::move(component);
 
     return ptr;
   }
@@ -113,12 +125,21 @@ public:
   id_t id;
   std::string name;
   GameObject *parent = nullptr;
+  /** Scene indexing this object and its slot there, set by Scene::track */
+  Scene *scene = nullptr;
+  ObjectHandle handle;
 
 private:
+  friend class Scene; // moves components between the object and its pools
+
   inline static id_t nextId = 1;
   id_t getNextId() { return nextId++; }
 
-  std::unordered_map<std::type_index, std::unique_ptr<Component>> components;
+  /** The scene's pool for a component type id */
+  ComponentPoolBase *scenePool(uint32_t typeId) const;
+
+  // Components of a detached object, indexed by componentId
+  std::array<std::unique_ptr<Component>, COMPONENT_TYPE_COUNT> components;
   std::vector<std::unique_ptr<GameObject>> children;
 };
 
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+namespace Magma {
+
+/**
+ * Generational reference to a GameObject in its Scene's slot map. Resolves
+ * to nullptr once the object is destroyed, even after its slot is reused,
+ * so holders never see a dangling object.
+ */
+struct ObjectHandle {
+  uint32_t index = 0;
+  uint32_t generation = 0; // live slots start at 1, so a default handle is null
+
+  explicit operator bool() const { return generation != 0; }
+  bool operator==(const ObjectHandle &) const = default;
+};
+
+} // namespace Magma
@@ -14,6 +14,20 @@ namespace Magma {
 ObjectPicker::ObjectPicker(VkExtent2D extent, uint32_t imageCount): targetExtent{extent}, imageCount_{imageCount} {
   createImages();
   idImageLayouts.resize(imageCount_, VK_IMAGE_LAYOUT_UNDEFINED);
+
+  readbackBuffer = std::make_unique<Buffer>(
+      sizeof(uint32_t), 1, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  readbackBuffer->map();
+  readbackCommands =
+      Device::get().allocateCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+}
+
+ObjectPicker::~ObjectPicker() {
+  destroyImages();
+
+  Device &device = Device::get();
+  vkFreeCommandBuffers(device.device(), device.getCommandPool(), 1, &readbackCommands);
 }
 
 // -----------------------------------------------------------------------------
@@ -113,13 +127,13 @@ void ObjectPicker::servicePendingPick() {
     return;
 
   GameObject *picked = pickAtPixel(pendingPick.x, pendingPick.y);
-  pendingPick.result = picked;
+  pendingPick.result = picked ? picked->handle : ObjectHandle{};
   pendingPick.hasRequest = false;
 }
 
 GameObject *ObjectPicker::pollPickResult() {
-  GameObject *result = pendingPick.result;
-  pendingPick.result = nullptr; 
+  GameObject *result = SceneManager::resolve(pendingPick.result);
+  pendingPick.result = {};
   return result;
 }
 
@@ -181,9 +195,9 @@ void ObjectPicker::destroyImages() {
       vkDestroyImage(device, idImages[i], nullptr);
       idImages[i] = VK_NULL_HANDLE;
     }
-    if (idImageMemories[i] != VK_NULL_HANDLE) {
-      vkFreeMemory(device, idImageMemories[i], nullptr);
-      idImageMemories[i] = VK_NULL_HANDLE;
+    if (idImageMemories[i].valid()) {
+      Device::freeMemory(idImageMemories[i]);
+      idImageMemories[i] = {};
     }
   }
   idImages.clear();
@@ -192,14 +206,12 @@ void ObjectPicker::destroyImages() {
 }
 
 GameObject *ObjectPicker::pickAtPixel(uint32_t x, uint32_t y) {
-    Buffer stagingBuffer(sizeof(uint32_t), 1, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    stagingBuffer.map();
-
     VkImage idImage = idImages[FrameInfo::frameIndex];
 
-    VkCommandBuffer cb = Device::get().beginSingleTimeCommands();
+    VkCommandBuffer cb = readbackCommands;
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cb, &beginInfo);
 
     // Transition ID image for readback (from shader read-only to transfer src)
     Device::transitionImageLayoutCmd(
@@ -220,7 +232,7 @@ GameObject *ObjectPicker::pickAtPixel(uint32_t x, uint32_t y) {
     region.imageOffset = {static_cast<int32_t>(x), static_cast<int32_t>(y), 0};
     region.imageExtent = {1, 1, 1};
 
-    Device::get().copyImageToBuffer(cb, stagingBuffer.getBuffer(),
+    Device::get().copyImageToBuffer(cb, readbackBuffer->getBuffer(),
                                     idImage, region);
 
     // Transition back to shader read-only
@@ -231,10 +243,10 @@ GameObject *ObjectPicker::pickAtPixel(uint32_t x, uint32_t y) {
         VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
         VK_IMAGE_ASPECT_COLOR_BIT);
 
-    Device::get().endSingleTimeCommands(cb);
+    Device::get().submitCommands(cb);
 
     uint32_t objectId = 0;
-    void *data = stagingBuffer.mappedData();
+    void *data = readbackBuffer->mappedData();
     if (data)
       memcpy(&objectId, data, sizeof(uint32_t));
 
@@ -1,7 +1,10 @@
 #pragma once
+#include "core/buffer.hpp"
+#include "core/memory_allocator.hpp"
 
 #include "engine/gameobject.hpp"
 #include "engine/render/features/render_feature.hpp"
+#include <memory>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 namespace Magma {
@@ -12,7 +15,7 @@ class ImageTransitionDescription;
 class ObjectPicker: public RenderFeature {
 public:
   ObjectPicker(VkExtent2D extent, uint32_t imageCount);
-  ~ObjectPicker() { destroyImages(); }
+  ~ObjectPicker();
 
   void onResize(VkExtent2D newExtent) override;
 
@@ -43,7 +46,7 @@ private:
 
   // Id image for object picking
   std::vector<VkImage> idImages;
-  std::vector<VkDeviceMemory> idImageMemories;
+  std::vector<Allocation> idImageMemories;
   std::vector<VkImageView> idImageViews;
   std::vector<VkImageLayout> idImageLayouts;
   VkFormat idImageFormat = VK_FORMAT_R32_UINT;
@@ -54,9 +57,13 @@ private:
   struct PendingPick {
     bool hasRequest = false;
     uint32_t x = 0, y = 0;
-    GameObject *result = nullptr;
+    ObjectHandle result; // the object may be destroyed before it is polled
   } pendingPick;
 
+  // Readback target and command buffer, reused by every pick
+  std::unique_ptr<Buffer> readbackBuffer;
+  VkCommandBuffer readbackCommands = VK_NULL_HANDLE;
+
     GameObject *pickAtPixel(uint32_t x, uint32_t y);
   };
 }
@@ -0,0 +1,61 @@
+#pragma once
+#include "core/frame_arena.hpp"
+#include "core/render_proxy.hpp"
+#include "engine/components/point_light.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace Magma {
+
+/** Camera a SceneRenderer draws with; each one gets its own visible list */
+enum class CameraSource : uint32_t {
+  Editor,
+  Scene
+};
+inline constexpr uint32_t CAMERA_SOURCE_COUNT = 2;
+
+struct MeshDraw {
+  MeshProxy mesh;
+  uint32_t objectIndex; // slot in the persistent ObjectTable
+  float worldScale;     // largest axis scale of the model matrix
+  uint32_t viewMask;    // bit per CameraSource that sees the object
+};
+
+// Instances sharing one vertex/index buffer, drawn with a single call.
+// [firstInstance, firstInstance + instanceCount) indexes the instance slot SSBO.
+struct DrawBatch {
+  MeshProxy mesh;
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+};
+
+/**
+ * Immutable result of the per-frame scene extraction.
+ * Built once per frame by the SceneExtractor and shared read-only by every
+ * SceneRenderer, which derive their own view data from it.
+ * Draws live in the frame arena and lights in the frame's mapped light
+ * buffer, so both are only valid until the end of the frame.
+ */
+struct FrameSnapshot {
+  PointLightSSBO *lights = nullptr;
+  ArenaArray<MeshDraw> meshDraws;
+  std::array<ArenaArray<DrawBatch>, CAMERA_SOURCE_COUNT> batches; // per CameraSource
+
+  std::optional<CameraProxy> sceneCamera;
+  std::optional<CameraProxy> editorCamera;
+
+  void clear() {
+    lights = nullptr;
+    meshDraws = {};
+    batches = {};
+    sceneCamera.reset();
+    editorCamera.reset();
+  }
+
+  const std::optional<CameraProxy> &camera(CameraSource source) const {
+    return source == CameraSource::Scene ? sceneCamera : editorCamera;
+  }
+};
+
+} // namespace Magma
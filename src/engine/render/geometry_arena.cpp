@@ -0,0 +1,155 @@
+#include "geometry_arena.hpp"
+#include "core/buffer.hpp"
+#include "core/deletion_queue.hpp"
+#include "core/device.hpp"
+#include "core/upload_service.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <stdexcept>
+
+namespace Magma {
+
+GeometryArena::GeometryArena() {
+  // Every vertex layout gets its own pages so a buffer has a single stride
+  for (size_t layout = 0; layout < VERTEX_LAYOUT_COUNT; ++layout) {
+    Pool &vertexPool = vertexPools[layout];
+    vertexPool.stride = VertexLayouts::stride(static_cast<VertexLayout>(layout));
+    vertexPool.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    vertexPool.pageCapacity = VERTEX_PAGE_CAPACITY;
+  }
+
+  indexPool.stride = sizeof(uint32_t);
+  indexPool.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  indexPool.pageCapacity = INDEX_PAGE_CAPACITY;
+
+  index16Pool.stride = sizeof(uint16_t);
+  index16Pool.usage = indexPool.usage;
+  index16Pool.pageCapacity = INDEX_PAGE_CAPACITY;
+
+  instance_ = this;
+}
+
+GeometryArena::~GeometryArena() {
+  instance_ = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+GeometryAllocation GeometryArena::allocate(GeometryKind kind, uint32_t count) {
+  if (count == 0) return {};
+
+  Pool &p = pool(kind);
+  for (uint32_t pageIndex = 0; pageIndex < p.pages.size(); ++pageIndex) {
+    auto &freeRanges = p.pages[pageIndex].freeRanges;
+    auto it = std::find_if(freeRanges.begin(), freeRanges.end(),
+                           [&](const auto &range) { return range.second >= count; });
+    if (it == freeRanges.end()) continue;
+
+    const uint32_t offset = it->first;
+    const uint32_t remaining = it->second - count;
+    freeRanges.erase(it);
+    if (remaining > 0)
+      freeRanges.emplace(offset + count, remaining);
+
+    return {kind, pageIndex, offset, count};
+  }
+
+  // Oversized meshes get a dedicated page of exactly their size
+  const bool dedicated = count > p.pageCapacity;
+  const uint32_t pageIndex = addPage(p, dedicated ? count : p.pageCapacity);
+  Page &page = p.pages[pageIndex];
+  page.dedicated = dedicated;
+  page.freeRanges.clear();
+  if (page.capacity > count)
+    page.freeRanges.emplace(count, page.capacity - count);
+
+  return {kind, pageIndex, 0, count};
+}
+
+void GeometryArena::free(const GeometryAllocation &allocation) {
+  if (!allocation.valid()) return;
+  if (isAlive() && get().releaseDedicated(allocation)) return;
+
+  DeletionQueue::push([allocation](VkDevice) {
+    if (GeometryArena::isAlive())
+      GeometryArena::get().release(allocation);
+  });
+}
+
+void GeometryArena::upload(const GeometryAllocation &allocation, const void *data) {
+  assert(allocation.valid() && "Cannot upload to an empty geometry allocation!");
+
+  Pool &p = pool(allocation.kind);
+  const VkDeviceSize size = allocation.count * p.stride;
+
+  const bool vertices = isVertexKind(allocation.kind);
+  Device::uploads().upload(getBuffer(allocation), allocation.offset * p.stride, data,
+                           size, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                           vertices ? VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                                    : VK_ACCESS_INDEX_READ_BIT);
+}
+
+VkBuffer GeometryArena::getBuffer(const GeometryAllocation &allocation) {
+  return pool(allocation.kind).pages[allocation.page].buffer->getBuffer();
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+uint32_t GeometryArena::addPage(Pool &p, uint32_t capacity) {
+  // Allocations refer to pages by index, so released slots stay in place
+  auto slot = std::find_if(p.pages.begin(), p.pages.end(),
+                           [](const Page &page) { return !page.buffer; });
+  if (slot == p.pages.end()) slot = p.pages.emplace(p.pages.end());
+
+  Page &page = *slot;
+  page.buffer = std::make_unique<Buffer>(p.stride, capacity, p.usage,
+                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  page.capacity = capacity;
+  page.dedicated = false;
+  page.freeRanges.clear();
+  page.freeRanges.emplace(0, capacity);
+  return static_cast<uint32_t>(std::distance(p.pages.begin(), slot));
+}
+
+void GeometryArena::release(const GeometryAllocation &allocation) {
+  auto &freeRanges = pool(allocation.kind).pages[allocation.page].freeRanges;
+
+  uint32_t offset = allocation.offset;
+  uint32_t count = allocation.count;
+
+  // Coalesce with the neighbouring free ranges
+  auto next = freeRanges.lower_bound(offset);
+  if (next != freeRanges.end() && offset + count == next->first) {
+    count += next->second;
+    next = freeRanges.erase(next);
+  }
+  if (next != freeRanges.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      prev->second += count;
+      return;
+    }
+  }
+  freeRanges.emplace(offset, count);
+}
+
+bool GeometryArena::releaseDedicated(const GeometryAllocation &allocation) {
+  Page &page = pool(allocation.kind).pages[allocation.page];
+  if (!page.dedicated) return false;
+
+  // Its only allocation is gone. Draws recorded for frames in flight hold
+  // the VkBuffer, which Buffer::cleanUp retires through the DeletionQueue,
+  // so the slot can take a new page right away
+  page.buffer.reset();
+  page.capacity = 0;
+  page.dedicated = false;
+  page.freeRanges.clear();
+  return true;
+}
+
+} // namespace Magma
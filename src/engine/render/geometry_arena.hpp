@@ -0,0 +1,101 @@
+#pragma once
+#include "core/buffer.hpp"
+#include "core/vertex_layout.hpp"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+/** One vertex kind per VertexLayout, in the same order */
+enum class GeometryKind : uint8_t {
+  Vertex,
+  VertexCompact,
+  VertexPacked,
+  Index,  // 32-bit indices
+  Index16
+};
+
+/** Element range inside one page of the GeometryArena */
+struct GeometryAllocation {
+  GeometryKind kind = GeometryKind::Vertex;
+  uint32_t page = 0;
+  uint32_t offset = 0; // in elements (vertices or indices)
+  uint32_t count = 0;
+
+  bool valid() const { return count > 0; }
+};
+
+/**
+ * Global store for mesh geometry.
+ * Vertices and indices are suballocated from a few large device-local pages
+ * with a first-fit free list, so meshes share buffers and draw with
+ * firstIndex/vertexOffset instead of owning a VkBuffer each. Meshes larger
+ * than a page get a dedicated page, released again along with the mesh.
+ * @note Owned by the RenderContext; reachable through GeometryArena::get()
+ */
+class GeometryArena {
+public:
+  static constexpr uint32_t VERTEX_PAGE_CAPACITY = 1u << 20; // vertices
+  static constexpr uint32_t INDEX_PAGE_CAPACITY  = 1u << 22; // indices
+
+  GeometryArena();
+  ~GeometryArena();
+
+  GeometryArena(const GeometryArena &) = delete;
+  GeometryArena &operator=(const GeometryArena &) = delete;
+
+  static GeometryArena &get() { return *instance_; }
+  static bool isAlive() { return instance_ != nullptr; }
+
+  static GeometryKind vertexKind(VertexLayout layout) {
+    return static_cast<GeometryKind>(static_cast<uint8_t>(GeometryKind::Vertex) +
+                                     static_cast<uint8_t>(layout));
+  }
+  static bool isVertexKind(GeometryKind kind) { return kind < GeometryKind::Index; }
+
+  GeometryAllocation allocate(GeometryKind kind, uint32_t count);
+  /** Returns the range once the frames currently in flight are done with it */
+  static void free(const GeometryAllocation &allocation);
+
+  void upload(const GeometryAllocation &allocation, const void *data);
+  VkBuffer getBuffer(const GeometryAllocation &allocation);
+
+private:
+  inline static GeometryArena *instance_ = nullptr;
+
+  struct Page {
+    std::unique_ptr<Buffer> buffer; // null once a dedicated page is released
+    uint32_t capacity = 0;
+    bool dedicated = false; // holds a single oversized allocation
+    std::map<uint32_t, uint32_t> freeRanges; // offset -> count
+  };
+
+  struct Pool {
+    std::vector<Page> pages;
+    VkDeviceSize stride = 0;
+    VkBufferUsageFlags usage = 0;
+    uint32_t pageCapacity = 0;
+  };
+  std::array<Pool, VERTEX_LAYOUT_COUNT> vertexPools;
+  Pool indexPool;
+  Pool index16Pool;
+
+  Pool &pool(GeometryKind kind) {
+    switch (kind) {
+    case GeometryKind::Index: return indexPool;
+    case GeometryKind::Index16: return index16Pool;
+    default: return vertexPools[static_cast<uint8_t>(kind)];
+    }
+  }
+  /** Returns the new page's index, reusing the slot of a released page */
+  uint32_t addPage(Pool &pool, uint32_t capacity);
+  void release(const GeometryAllocation &allocation);
+  /** Releases the page of an allocation if it's a dedicated one */
+  bool releaseDedicated(const GeometryAllocation &allocation);
+};
+
+} // namespace Magma
@@ -0,0 +1,177 @@
+#include "object_table.hpp"
+#include "core/buffer.hpp"
+#include "core/object_data.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+namespace {
+constexpr VkDeviceSize kStride = sizeof(ObjectData);
+} // namespace
+
+ObjectTable::ObjectTable() {
+  capacity_ = INITIAL_CAPACITY;
+  gpuBuffer = createGpuBuffer(capacity_);
+}
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void ObjectTable::beginFrame() {
+  epoch++;
+}
+
+uint32_t ObjectTable::acquireSlot(uint64_t key) {
+  auto it = slotOf.find(key);
+  if (it != slotOf.end()) {
+    slots[it->second].epoch = epoch;
+    return it->second;
+  }
+
+  uint32_t slot;
+  if (!freeSlots.empty()) {
+    slot = freeSlots.back();
+    freeSlots.pop_back();
+  } else {
+    slot = static_cast<uint32_t>(slots.size());
+    slots.emplace_back();
+    cpuObjects.emplace_back();
+  }
+
+  // version 0 never matches a written version, so the first write uploads
+  slots[slot] = {.key = key, .version = 0, .epoch = epoch, .live = true};
+  slotOf.emplace(key, slot);
+  return slot;
+}
+
+void ObjectTable::endFrame() {
+  for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+    SlotInfo &info = slots[slot];
+    if (!info.live || info.epoch == epoch) continue;
+
+    slotOf.erase(info.key);
+    info.live = false;
+    freeSlots.push_back(slot);
+  }
+}
+
+void ObjectTable::write(uint32_t slot, uint32_t version, const ObjectData &data) {
+  SlotInfo &info = slots[slot];
+  if (info.version == version) return;
+
+  info.version = version;
+  cpuObjects[slot] = data;
+  if (!info.dirty) {
+    info.dirty = true;
+    dirtySlots.push_back(slot);
+  }
+}
+
+void ObjectTable::recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+  const bool needsGrowth = slots.size() > capacity_;
+  if (dirtySlots.empty() && !needsGrowth) return;
+
+  // Previous frames may still read the table in their vertex stage
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0,
+                       nullptr, 0, nullptr);
+
+  if (needsGrowth)
+    grow(commandBuffer);
+
+  if (!dirtySlots.empty()) {
+    std::sort(dirtySlots.begin(), dirtySlots.end());
+    ensureStaging(frameIndex, dirtySlots.size() * kStride);
+
+    auto *staging = static_cast<ObjectData *>(stagingBuffers[frameIndex]->mappedData());
+    copyRegions.clear();
+
+    for (size_t i = 0; i < dirtySlots.size(); ++i) {
+      const uint32_t slot = dirtySlots[i];
+      staging[i] = cpuObjects[slot];
+      slots[slot].dirty = false;
+
+      // Extend the previous region when the slot follows it directly
+      if (!copyRegions.empty() && i > 0 && dirtySlots[i - 1] + 1 == slot) {
+        copyRegions.back().size += kStride;
+        continue;
+      }
+      copyRegions.push_back({.srcOffset = i * kStride,
+                             .dstOffset = slot * kStride,
+                             .size = kStride});
+    }
+
+    vkCmdCopyBuffer(commandBuffer, stagingBuffers[frameIndex]->getBuffer(),
+                    gpuBuffer->getBuffer(),
+                    static_cast<uint32_t>(copyRegions.size()),
+                    copyRegions.data());
+    dirtySlots.clear();
+  }
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &barrier, 0,
+                       nullptr, 0, nullptr);
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+std::unique_ptr<Buffer> ObjectTable::createGpuBuffer(uint32_t slotCount) {
+  return std::make_unique<Buffer>(
+      kStride, slotCount,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void ObjectTable::grow(VkCommandBuffer commandBuffer) {
+  uint32_t newCapacity = capacity_;
+  while (newCapacity < slots.size())
+    newCapacity *= 2;
+
+  std::unique_ptr<Buffer> newBuffer = createGpuBuffer(newCapacity);
+
+  VkBufferCopy region{.srcOffset = 0, .dstOffset = 0, .size = capacity_ * kStride};
+  vkCmdCopyBuffer(commandBuffer, gpuBuffer->getBuffer(), newBuffer->getBuffer(),
+                  1, &region);
+
+  // Dirty copies below may overwrite ranges written by the growth copy
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0,
+                       nullptr, 0, nullptr);
+
+  // Old buffer is released through the DeletionQueue once in-flight frames finish
+  gpuBuffer = std::move(newBuffer);
+  capacity_ = newCapacity;
+  generation_++;
+}
+
+void ObjectTable::ensureStaging(uint32_t frameIndex, VkDeviceSize size) {
+  auto &staging = stagingBuffers[frameIndex];
+  if (staging && staging->getBufferSize() >= size) return;
+
+  VkDeviceSize newSize = staging ? staging->getBufferSize() : kStride * 64;
+  while (newSize < size)
+    newSize *= 2;
+
+  staging = std::make_unique<Buffer>(
+      newSize, 1, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  staging->map();
+}
+
+} // namespace Magma
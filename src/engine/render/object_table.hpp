@@ -0,0 +1,75 @@
+#pragma once
+#include "core/buffer.hpp"
+#include "core/object_data.hpp"
+#include "core/swapchain.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Magma {
+
+/**
+ * Persistent GPU table of ObjectData, indexed by a stable per-object slot.
+ * Lives in a single device-local storage buffer that grows geometrically.
+ * Only slots written since the last upload are copied, coalesced into
+ * contiguous VkBufferCopy regions from a per-frame staging buffer.
+ */
+class ObjectTable {
+public:
+  static constexpr uint32_t INITIAL_CAPACITY = 1024;
+
+  ObjectTable();
+  ~ObjectTable() = default;
+
+  ObjectTable(const ObjectTable &) = delete;
+  ObjectTable &operator=(const ObjectTable &) = delete;
+
+  // Slot lifetime — slots not acquired between beginFrame/endFrame are released
+  void beginFrame();
+  uint32_t acquireSlot(uint64_t key);
+  void endFrame();
+
+  /** Stores data for the slot if its version differs from the uploaded one */
+  void write(uint32_t slot, uint32_t version, const ObjectData &data);
+
+  /** Records growth and dirty-slot copies into the frame's command buffer */
+  void recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+  VkBuffer getBuffer() const { return gpuBuffer->getBuffer(); }
+  uint32_t capacity() const { return capacity_; }
+  uint32_t liveCount() const { return static_cast<uint32_t>(slotOf.size()); }
+
+  /** Incremented whenever the GPU buffer is reallocated */
+  uint64_t generation() const { return generation_; }
+
+private:
+  struct SlotInfo {
+    uint64_t key = 0;
+    uint32_t version = 0;
+    uint32_t epoch = 0;
+    bool live = false;
+    bool dirty = false;
+  };
+
+  std::unique_ptr<Buffer> gpuBuffer;
+  uint32_t capacity_ = 0;
+  uint64_t generation_ = 0;
+  std::unique_ptr<Buffer> createGpuBuffer(uint32_t slotCount);
+  void grow(VkCommandBuffer commandBuffer);
+
+  std::array<std::unique_ptr<Buffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> stagingBuffers;
+  void ensureStaging(uint32_t frameIndex, VkDeviceSize size);
+
+  std::vector<ObjectData> cpuObjects;
+  std::vector<SlotInfo> slots;
+  std::unordered_map<uint64_t, uint32_t> slotOf;
+  std::vector<uint32_t> freeSlots;
+  std::vector<uint32_t> dirtySlots;
+  std::vector<VkBufferCopy> copyRegions;
+  uint32_t epoch = 0;
+};
+
+} // namespace Magma
@@ -247,8 +247,8 @@ void OffscreenTarget::destroyColorResources() {
   for (size_t i = 0; i < images.size(); ++i) {
     if (images[i] != VK_NULL_HANDLE)
       vkDestroyImage(device, images[i], nullptr);
-    if (imageMemories[i] != VK_NULL_HANDLE)
-      vkFreeMemory(device, imageMemories[i], nullptr);
+    if (imageMemories[i].valid())
+      Device::freeMemory(imageMemories[i]);
   }
 
   images.clear();
@@ -310,8 +310,8 @@ void OffscreenTarget::destroyDepthResources() {
       vkDestroyImageView(device, depthImageViews[i], nullptr);
     if (depthImages[i] != VK_NULL_HANDLE)
       vkDestroyImage(device, depthImages[i], nullptr);
-    if (depthImageMemories[i] != VK_NULL_HANDLE)
-      vkFreeMemory(device, depthImageMemories[i], nullptr);
+    if (depthImageMemories[i].valid())
+      Device::freeMemory(depthImageMemories[i]);
   }
   depthImages.clear();
   depthImageMemories.clear();
@@ -1,4 +1,5 @@
 #pragma once
+#include "core/memory_allocator.hpp"
 #include "core/render_target.hpp"
 #include "core/render_target_info.hpp"
 #include <print>
@@ -44,7 +45,7 @@ private:
   uint32_t imageCount_ = 0;
   std::vector<VkImage> images = {VK_NULL_HANDLE};
   std::vector<VkImageView> imageViews = {VK_NULL_HANDLE};
-  std::vector<VkDeviceMemory> imageMemories = {VK_NULL_HANDLE};
+  std::vector<Allocation> imageMemories = {Allocation{}};
   std::vector<VkImageLayout> imageLayouts = {VK_IMAGE_LAYOUT_UNDEFINED};
   VkFormat imageFormat = VK_FORMAT_R8G8B8A8_UNORM;
   void createImages();
@@ -53,7 +54,7 @@ private:
 
   // Depth images (offscreen-owned)
   std::vector<VkImage> depthImages = {VK_NULL_HANDLE};
-  std::vector<VkDeviceMemory> depthImageMemories = {VK_NULL_HANDLE};
+  std::vector<Allocation> depthImageMemories = {Allocation{}};
   std::vector<VkImageView> depthImageViews = {VK_NULL_HANDLE};
   std::vector<VkImageLayout> depthImageLayouts = {VK_IMAGE_LAYOUT_UNDEFINED};
   VkFormat depthImageFormat = VK_FORMAT_D32_SFLOAT;
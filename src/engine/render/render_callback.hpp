@@ -1,8 +1,12 @@
 #pragma once
+#include "core/device.hpp"
 #include "core/frame_info.hpp"
 #include "core/push_constant_data.hpp"
 #include "core/render_proxy.hpp"
 #include "core/renderer.hpp"
+#include "engine/render/frame_snapshot.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <vulkan/vulkan_core.h>
 
@@ -10,9 +14,7 @@ namespace Magma {
 
 class RenderCallback {
 public:
-  static void renderMesh(const MeshProxy &mesh, uint32_t objectIndex) {
-    if (!mesh.meshData) return;
-
+  static void bindMesh(const MeshProxy &mesh) {
     VkBuffer vertexBuffers[] = {mesh.vertexBuffer};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(FrameInfo::commandBuffer, 0, 1, vertexBuffers, offsets);
@@ -21,20 +23,124 @@ public:
       assert(mesh.indexBuffer != VK_NULL_HANDLE &&
              "Index buffer must be valid before rendering indexed mesh!");
       vkCmdBindIndexBuffer(FrameInfo::commandBuffer, mesh.indexBuffer, 0,
-                           VK_INDEX_TYPE_UINT32);
+                           mesh.indexType);
     }
+  }
+
+  static void renderMesh(const MeshProxy &mesh, uint32_t firstInstance,
+                         uint32_t instanceCount = 1) {
+    if (!mesh.asset) return;
+
+    bindMesh(mesh);
+    drawMesh(mesh, firstInstance, instanceCount);
+  }
 
+  static void drawMesh(const MeshProxy &mesh, uint32_t firstInstance,
+                       uint32_t instanceCount) {
     if (mesh.hasIndexBuffer)
-      vkCmdDrawIndexed(FrameInfo::commandBuffer, mesh.indexCount, 1, 0, 0, objectIndex);
+      vkCmdDrawIndexed(FrameInfo::commandBuffer, mesh.indexCount, instanceCount,
+                       mesh.firstIndex, mesh.vertexOffset, firstInstance);
     else
-      vkCmdDraw(FrameInfo::commandBuffer, mesh.vertexCount, 1, 0, objectIndex);
+      vkCmdDraw(FrameInfo::commandBuffer, mesh.vertexCount, instanceCount,
+                static_cast<uint32_t>(mesh.vertexOffset), firstInstance);
+  }
+
+  /**
+   * Submits batches in order. Consecutive batches sharing buffers and instance
+   * count go out as one vkCmdDrawMulti(Indexed)EXT call when VK_EXT_multi_draw
+   * is available, otherwise as one instanced draw each. Geometry arena pages
+   * and vertex layout pipelines are only rebound when they change between
+   * batches; the renderer is expected to have bound its Standard pipeline.
+   */
+  static void renderBatches(IRenderer &renderer, const DrawBatch *batches,
+                            uint32_t count) {
+    const MultiDrawSupport &multiDraw = Device::multiDraw();
+    VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+    VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+    VertexLayout boundLayout = VertexLayout::Standard;
+    auto bindIfChanged = [&](const MeshProxy &mesh) {
+      if (mesh.vertexLayout != boundLayout) {
+        renderer.bindPipeline(mesh.vertexLayout);
+        boundLayout = mesh.vertexLayout;
+      }
+      if (mesh.vertexBuffer == boundVertexBuffer &&
+          mesh.indexBuffer == boundIndexBuffer)
+        return;
+      bindMesh(mesh);
+      boundVertexBuffer = mesh.vertexBuffer;
+      boundIndexBuffer = mesh.indexBuffer;
+    };
+
+    uint32_t i = 0;
+    while (i < count) {
+      const DrawBatch &first = batches[i];
+      uint32_t end = i + 1;
+      while (end < count && sharesMultiDraw(first, batches[end]))
+        end++;
+
+      if (!multiDraw.supported || end - i == 1) {
+        pushInstanceStride(renderer, 0);
+        for (; i < end; ++i) {
+          if (!batches[i].mesh.asset) continue;
+          bindIfChanged(batches[i].mesh);
+          drawMesh(batches[i].mesh, batches[i].firstInstance, batches[i].instanceCount);
+        }
+        continue;
+      }
+
+      if (!first.mesh.asset) {
+        i = end;
+        continue;
+      }
+
+      bindIfChanged(first.mesh);
+      pushInstanceStride(renderer, first.instanceCount);
+
+      // Batch instance ranges are laid out back to back, so each chunk only
+      // needs the first instance of its first draw.
+      const uint32_t maxChunk = std::min<uint32_t>(multiDraw.maxDrawCount, MULTI_DRAW_CHUNK);
+      while (i < end) {
+        const uint32_t chunk = std::min(end - i, maxChunk);
+        const uint32_t firstInstance = batches[i].firstInstance;
+
+        if (first.mesh.hasIndexBuffer) {
+          std::array<VkMultiDrawIndexedInfoEXT, MULTI_DRAW_CHUNK> infos;
+          for (uint32_t d = 0; d < chunk; ++d) {
+            const MeshProxy &mesh = batches[i + d].mesh;
+            infos[d] = {mesh.firstIndex, mesh.indexCount, mesh.vertexOffset};
+          }
+          multiDraw.cmdDrawMultiIndexed(FrameInfo::commandBuffer, chunk, infos.data(),
+                                        first.instanceCount, firstInstance,
+                                        sizeof(VkMultiDrawIndexedInfoEXT), nullptr);
+        } else {
+          std::array<VkMultiDrawInfoEXT, MULTI_DRAW_CHUNK> infos;
+          for (uint32_t d = 0; d < chunk; ++d) {
+            const MeshProxy &mesh = batches[i + d].mesh;
+            infos[d] = {static_cast<uint32_t>(mesh.vertexOffset), mesh.vertexCount};
+          }
+          multiDraw.cmdDrawMulti(FrameInfo::commandBuffer, chunk, infos.data(),
+                                 first.instanceCount, firstInstance,
+                                 sizeof(VkMultiDrawInfoEXT));
+        }
+        i += chunk;
+      }
+    }
+  }
+
+private:
+  static constexpr uint32_t MULTI_DRAW_CHUNK = 256;
+
+  static bool sharesMultiDraw(const DrawBatch &a, const DrawBatch &b) {
+    return a.mesh.vertexLayout == b.mesh.vertexLayout &&
+           a.mesh.vertexBuffer == b.mesh.vertexBuffer &&
+           a.mesh.indexBuffer == b.mesh.indexBuffer &&
+           a.mesh.hasIndexBuffer == b.mesh.hasIndexBuffer &&
+           a.instanceCount == b.instanceCount;
   }
 
-  static void renderTransform(IRenderer &renderer, const TransformProxy &transform) {
+  static void pushInstanceStride(IRenderer &renderer, uint32_t stride) {
     PushConstantData push{};
-    push.modelMatrix = transform.modelMatrix;
-    push.normalMatrix = transform.normalMatrix;
-    push.objectId = transform.objectId;
+    push.instanceStride = stride;
 
     vkCmdPushConstants(FrameInfo::commandBuffer, renderer.getPipelineLayout(),
                        VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantData),
@@ -1,5 +1,4 @@
 #include "render_context.hpp"
-#include "core/object_data.hpp"
 #include "core/swapchain.hpp"
 #include "engine/components/point_light.hpp"
 #include <stdexcept>
@@ -7,12 +6,18 @@
 
 namespace Magma {
 
+RenderContext::RenderContext() {
+  geometryArena = std::make_unique<GeometryArena>();
+}
+
 RenderContext::~RenderContext(){
+  geometryArena.reset();
   descriptorPool = nullptr;
   layouts.clear();
 
-  for (auto &buffer: objectBuffers)
-    buffer->cleanUp();
+  objectTable.reset();
+  for (auto &buffer: instanceSlotBuffers)
+    buffer.reset();
   for (auto &buffer: pointLightBuffers)
     buffer->cleanUp();
 }
@@ -30,14 +35,41 @@ VkDescriptorSet RenderContext::getDescriptorSet(LayoutKey key, uint32_t frameInd
   throw std::runtime_error("RenderContext: unknown LayoutKey");
 }
 
-void RenderContext::updateObjects(uint32_t frameIndex, const void *data, VkDeviceSize size) {
-  objectBuffers[frameIndex]->writeToBuffer(const_cast<void *>(data), size);
-  objectBuffers[frameIndex]->flush(size);
+ObjectTable &RenderContext::getObjectTable() {
+  ensureLayout(LayoutKey::ObjectStorage);
+  return *objectTable;
+}
+
+void RenderContext::uploadObjects(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+  ObjectTable &table = getObjectTable();
+  table.recordUpload(commandBuffer, frameIndex);
+
+  // The table may have been reallocated; this frame's set is no longer in use
+  if (objectSetGenerations[frameIndex] != table.generation())
+    writeObjectStorageSet(frameIndex);
+}
+
+uint32_t *RenderContext::mapInstanceSlots(uint32_t frameIndex, uint32_t count) {
+  ensureLayout(LayoutKey::ObjectStorage);
+
+  auto &buffer = instanceSlotBuffers[frameIndex];
+  const VkDeviceSize required = count * sizeof(uint32_t);
+  if (buffer->getBufferSize() < required) {
+    VkDeviceSize newCount = buffer->getBufferSize() / sizeof(uint32_t);
+    while (newCount * sizeof(uint32_t) < required)
+      newCount *= 2;
+
+    // Called before recording, so this frame's set can be rewritten in place
+    buffer = createInstanceSlotBuffer(static_cast<uint32_t>(newCount));
+    writeObjectStorageSet(frameIndex);
+  }
+
+  return static_cast<uint32_t *>(buffer->mappedData());
 }
 
-void RenderContext::updatePointLights(uint32_t frameIndex, const void *data, VkDeviceSize size) {
-  pointLightBuffers[frameIndex]->writeToBuffer(const_cast<void *>(data), size);
-  pointLightBuffers[frameIndex]->flush(size);
+PointLightSSBO *RenderContext::mapPointLights(uint32_t frameIndex) {
+  ensureLayout(LayoutKey::PointLight);
+  return static_cast<PointLightSSBO *>(pointLightBuffers[frameIndex]->mappedData());
 }
 
 // -----------------------------------------------------------------------------
@@ -49,7 +81,7 @@ void RenderContext::ensureDescriptorPool() {
     return;
   descriptorPool = DescriptorPool::Builder()
       .setMaxSets(2 * SwapChain::MAX_FRAMES_IN_FLIGHT)
-      .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * SwapChain::MAX_FRAMES_IN_FLIGHT)
+      .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * SwapChain::MAX_FRAMES_IN_FLIGHT)
       .setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
       .build();
 }
@@ -62,6 +94,7 @@ void RenderContext::ensureLayout(LayoutKey key) {
   case LayoutKey::ObjectStorage:
     layouts[key] = DescriptorSetLayout::Builder()
         .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+        .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
         .build();
     initObjectStorage();
     break;
@@ -79,27 +112,58 @@ void RenderContext::initObjectStorage() {
     return;
 
   ensureDescriptorPool();
+  objectTable = std::make_unique<ObjectTable>();
 
   for (uint32_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-    objectBuffers[i] = std::make_unique<Buffer>(
-        sizeof(ObjectStorageSSBO), 1,
-        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    objectBuffers[i]->map();
+    instanceSlotBuffers[i] = createInstanceSlotBuffer(ObjectTable::INITIAL_CAPACITY);
 
-    VkDescriptorBufferInfo info{};
-    info.buffer = objectBuffers[i]->getBuffer();
-    info.offset = 0;
-    info.range  = sizeof(ObjectStorageSSBO);
+    VkDescriptorBufferInfo objectInfo{};
+    objectInfo.buffer = objectTable->getBuffer();
+    objectInfo.offset = 0;
+    objectInfo.range  = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo instanceInfo{};
+    instanceInfo.buffer = instanceSlotBuffers[i]->getBuffer();
+    instanceInfo.offset = 0;
+    instanceInfo.range  = VK_WHOLE_SIZE;
 
     DescriptorWriter(*layouts[LayoutKey::ObjectStorage], *descriptorPool)
-        .writeBuffer(0, &info, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .writeBuffer(0, &objectInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .writeBuffer(1, &instanceInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
         .build(objectStorageSets[i]);
+    objectSetGenerations[i] = objectTable->generation();
   }
 
   objectStorageInitialized = true;
 }
 
+void RenderContext::writeObjectStorageSet(uint32_t frameIndex) {
+  VkDescriptorBufferInfo objectInfo{};
+  objectInfo.buffer = objectTable->getBuffer();
+  objectInfo.offset = 0;
+  objectInfo.range  = VK_WHOLE_SIZE;
+
+  VkDescriptorBufferInfo instanceInfo{};
+  instanceInfo.buffer = instanceSlotBuffers[frameIndex]->getBuffer();
+  instanceInfo.offset = 0;
+  instanceInfo.range  = VK_WHOLE_SIZE;
+
+  DescriptorWriter(*layouts[LayoutKey::ObjectStorage], *descriptorPool)
+      .writeBuffer(0, &objectInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+      .writeBuffer(1, &instanceInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+      .overwrite(objectStorageSets[frameIndex]);
+  objectSetGenerations[frameIndex] = objectTable->generation();
+}
+
+std::unique_ptr<Buffer> RenderContext::createInstanceSlotBuffer(uint32_t count) {
+  auto buffer = std::make_unique<Buffer>(
+      sizeof(uint32_t), count,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  buffer->map();
+  return buffer;
+}
+
 void RenderContext::initPointLightBuffers() {
   if (pointLightInitialized)
     return;
@@ -2,6 +2,8 @@
 #include "core/buffer.hpp"
 #include "core/descriptors.hpp"
 #include "core/swapchain.hpp"
+#include "engine/render/geometry_arena.hpp"
+#include "engine/render/object_table.hpp"
 #include <array>
 #include <memory>
 #include <unordered_map>
@@ -9,6 +11,8 @@
 
 namespace Magma {
 
+struct PointLightSSBO;
+
 enum class LayoutKey {
   ObjectStorage = 0,
   PointLight = 1,
@@ -16,11 +20,12 @@ enum class LayoutKey {
 
 /**
  * Singleton that owns scene-global GPU resources shared across all renderers.
- * Currently manages the point light SSBO and its descriptor sets.
+ * Currently manages the geometry arena, the persistent object table, the
+ * per-frame instance slot and point light SSBOs and their descriptor sets.
  */
 class RenderContext {
 public:
-  RenderContext() = default;
+  RenderContext();
   ~RenderContext();
 
   RenderContext(const RenderContext &) = delete;
@@ -29,20 +34,32 @@ public:
   VkDescriptorSetLayout getLayout(LayoutKey key);
   VkDescriptorSet getDescriptorSet(LayoutKey key, uint32_t frameIndex);
 
-  void updateObjects(uint32_t frameIndex, const void *data, VkDeviceSize size);
-  void updatePointLights(uint32_t frameIndex, const void *data, VkDeviceSize size);
+  ObjectTable &getObjectTable();
+  void uploadObjects(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+  /** Persistently mapped instance -> object slot buffer for the given frame,
+   *  grown to hold at least count entries */
+  uint32_t *mapInstanceSlots(uint32_t frameIndex, uint32_t count);
+  /** Persistently mapped, host-coherent light buffer for the given frame */
+  PointLightSSBO *mapPointLights(uint32_t frameIndex);
 
 private:
+  std::unique_ptr<GeometryArena> geometryArena;
+
   std::unique_ptr<DescriptorPool> descriptorPool;
   void ensureDescriptorPool();
 
   std::unordered_map<LayoutKey, std::unique_ptr<DescriptorSetLayout>> layouts;
   void ensureLayout(LayoutKey key);
 
-  std::array<std::unique_ptr<Buffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> objectBuffers;
+  std::unique_ptr<ObjectTable> objectTable;
   std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> objectStorageSets{};
+  std::array<uint64_t, SwapChain::MAX_FRAMES_IN_FLIGHT> objectSetGenerations{};
+  std::array<std::unique_ptr<Buffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> instanceSlotBuffers;
+  std::unique_ptr<Buffer> createInstanceSlotBuffer(uint32_t count);
   bool objectStorageInitialized = false;
   void initObjectStorage();
+  void writeObjectStorageSet(uint32_t frameIndex);
 
   std::array<std::unique_ptr<Buffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> pointLightBuffers;
   std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> pointLightSets{};
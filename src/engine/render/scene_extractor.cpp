@@ -0,0 +1,278 @@
+#include "engine/render/scene_extractor.hpp"
+#include "core/frame_arena.hpp"
+#include "core/cooked_mesh.hpp"
+#include "core/frame_info.hpp"
+#include "core/job_system.hpp"
+#include "core/frustum.hpp"
+#include "core/object_data.hpp"
+#include "engine/components/camera.hpp"
+#include "engine/components/mesh.hpp"
+#include "engine/components/point_light.hpp"
+#include "engine/components/transform.hpp"
+#include "engine/gameobject.hpp"
+#include "engine/render/object_table.hpp"
+#include "engine/render/render_context.hpp"
+#include "engine/scene.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+namespace Magma {
+
+namespace {
+constexpr uint32_t kMaxPointLights =
+    sizeof(PointLightSSBO::lights) / sizeof(PointLightData);
+// Draws per job; culling is a few SIMD ops per draw, LOD selection a bit more
+constexpr uint32_t CULL_GRAIN = 4096;
+constexpr uint32_t LOD_GRAIN = 1024;
+
+} // namespace
+
+const FrameSnapshot &SceneExtractor::extract(Scene *scene, RenderContext &context,
+                                             FrameArena &arena) {
+  frameSnapshot.clear();
+  frameSnapshot.editorCamera = editorCameraProxy.camera;
+  frameSnapshot.lights = context.mapPointLights(FrameInfo::frameIndex);
+  frameSnapshot.lights->lightCount = 0;
+
+  ObjectTable &objectTable = context.getObjectTable();
+  objectTable.beginFrame();
+  if (scene)
+    extractScene(*scene, objectTable, arena);
+  objectTable.endFrame();
+
+  selectLods();
+  cullViews(arena);
+  buildBatches(context, arena);
+
+  return frameSnapshot;
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+void SceneExtractor::extractScene(Scene &scene, ObjectTable &objectTable,
+                                  FrameArena &arena) {
+  // Transform propagation and component updates, in parallel where they
+  // don't touch the same component types
+  scene.updateSystems();
+
+  // Every Mesh contributes at most one draw
+  const ComponentPool<Mesh> *meshes = scene.findPool<Mesh>();
+  const uint32_t capacity = meshes ? meshes->size() : 0;
+  frameSnapshot.meshDraws = arena.allocArray<MeshDraw>(capacity);
+  for (float **stream : {&bounds.centerX, &bounds.centerY, &bounds.centerZ, &bounds.extentX,
+                         &bounds.extentY, &bounds.extentZ, &bounds.radius})
+    *stream = arena.allocArray<float>(capacity).data();
+
+  scene.view<Transform, Mesh>().each([&](GameObject &go, Transform &transform, Mesh &mesh) {
+    RenderProxy proxy = {};
+    transform.collectProxy(proxy);
+    mesh.collectProxy(proxy);
+    extractDraw(go, proxy, objectTable);
+  });
+
+  PointLightSSBO &lights = *frameSnapshot.lights;
+  scene.view<PointLight>().each([&](GameObject &, PointLight &light) {
+    if (lights.lightCount >= kMaxPointLights) return;
+    RenderProxy proxy = {};
+    light.collectProxy(proxy);
+    lights.lights[lights.lightCount] = {
+        proxy.pointLight->position,
+        proxy.pointLight->color,
+    };
+    lights.lightCount++;
+  });
+
+  if (GameObject *activeCamera = scene.getActiveCamera())
+    if (Camera *camera = activeCamera->getComponent<Camera>()) {
+      RenderProxy proxy = {};
+      camera->collectProxy(proxy);
+      frameSnapshot.sceneCamera = proxy.camera;
+    }
+}
+
+void SceneExtractor::extractDraw(const GameObject &go, const RenderProxy &proxy,
+                                 ObjectTable &objectTable) {
+  if (proxy.mesh && proxy.transform) {
+    uint32_t slot = objectTable.acquireSlot(go.id);
+    objectTable.write(slot, proxy.transform->version, {
+        .modelMatrix = proxy.transform->modelMatrix,
+        .normalMatrix = proxy.transform->normalMatrix,
+        .objectID = proxy.transform->objectId,
+    });
+    if (slot >= lodStates.size()) lodStates.resize(slot + 1);
+    if (lodStates[slot].key != go.id) lodStates[slot] = {go.id, 0};
+
+    // World box of the transformed object box, and the object sphere
+    // scaled by the largest axis
+    const glm::mat4 &model = proxy.transform->modelMatrix;
+    const glm::vec3 axes[3] = {glm::vec3{model[0]}, glm::vec3{model[1]}, glm::vec3{model[2]}};
+    const float worldScale = std::max({glm::length(axes[0]), glm::length(axes[1]),
+                                       glm::length(axes[2])});
+    glm::vec3 center{model[3]};
+    glm::vec3 extent{0.f};
+    float radius = 0.f;
+    if (const CookedMesh *asset = proxy.mesh->asset) {
+      const Bounds &local = asset->bounds();
+      const glm::vec3 localExtent = local.extent();
+      center = glm::vec3{model * glm::vec4{local.center(), 1.f}};
+      extent = glm::abs(axes[0]) * localExtent.x + glm::abs(axes[1]) * localExtent.y +
+               glm::abs(axes[2]) * localExtent.z;
+      radius = local.radius * worldScale;
+    }
+
+    const uint32_t draw = frameSnapshot.meshDraws.size();
+    bounds.centerX[draw] = center.x;
+    bounds.centerY[draw] = center.y;
+    bounds.centerZ[draw] = center.z;
+    bounds.extentX[draw] = extent.x;
+    bounds.extentY[draw] = extent.y;
+    bounds.extentZ[draw] = extent.z;
+    bounds.radius[draw] = radius;
+    frameSnapshot.meshDraws.push_back({*proxy.mesh, slot, worldScale, 0});
+  }
+}
+
+void SceneExtractor::selectLods() {
+  // The editor view is the one being looked at whenever there is one
+  const std::optional<CameraProxy> &camera =
+      frameSnapshot.editorCamera ? frameSnapshot.editorCamera : frameSnapshot.sceneCamera;
+  if (!camera || camera->lodScale <= 0.f) return;
+
+  // Draws own distinct LodStates, so ranges of them are independent
+  JobSystem::get().parallelFor(
+      frameSnapshot.meshDraws.size(), LOD_GRAIN, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      MeshDraw &draw = frameSnapshot.meshDraws[i];
+      if (!draw.mesh.asset || !draw.mesh.hasIndexBuffer) continue;
+      const auto lods = draw.mesh.asset->lods();
+      if (lods.size() < 2) continue;
+
+      const glm::vec3 center{bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]};
+      const float distance = glm::length(center - camera->position) - bounds.radius[i];
+      // Screen heights covered by one object space unit; inside the sphere
+      // everything counts as close enough for full detail
+      const float toScreen = distance > 0.f
+          ? draw.worldScale * camera->lodScale / distance
+          : std::numeric_limits<float>::infinity();
+
+      // Refine as soon as the current level is too coarse, but only coarsen
+      // once the next level is well below the threshold, so levels don't
+      // flicker when the distance hovers around a switch point
+      uint8_t &lod = lodStates[draw.objectIndex].lod;
+      lod = static_cast<uint8_t>(std::min<size_t>(lod, lods.size() - 1));
+      while (lod > 0 && lods[lod].error * toScreen > LOD_SCREEN_ERROR)
+        lod--;
+      while (lod + 1u < lods.size() &&
+             lods[lod + 1].error * toScreen <= LOD_SCREEN_ERROR * LOD_HYSTERESIS)
+        lod++;
+
+      // Proxies carry LOD 0, whose range starts at the geometry's first index
+      draw.mesh.firstIndex += lods[lod].firstIndex - lods[0].firstIndex;
+      draw.mesh.indexCount = lods[lod].indexCount;
+    }
+  });
+}
+
+void SceneExtractor::cullViews(FrameArena &arena) {
+  ArenaArray<MeshDraw> &draws = frameSnapshot.meshDraws;
+  if (draws.empty()) return;
+
+  std::optional<Frustum> frusta[CAMERA_SOURCE_COUNT];
+  for (uint32_t view = 0; view < CAMERA_SOURCE_COUNT; ++view)
+    if (const auto &camera = frameSnapshot.camera(static_cast<CameraSource>(view)))
+      frusta[view] = Frustum::fromMatrix(camera->projView);
+
+  // Each range of draws is tested against every view
+  uint32_t *masks = arena.allocArray<uint32_t>(draws.size()).data();
+  JobSystem::get().parallelFor(draws.size(), CULL_GRAIN, [&](uint32_t begin, uint32_t end) {
+    const CullBounds range = {bounds.centerX + begin, bounds.centerY + begin,
+                              bounds.centerZ + begin, bounds.extentX + begin,
+                              bounds.extentY + begin, bounds.extentZ + begin,
+                              bounds.radius + begin};
+    std::fill(masks + begin, masks + end, 0u);
+    for (uint32_t view = 0; view < CAMERA_SOURCE_COUNT; ++view) {
+      const uint32_t viewBit = 1u << view;
+      // Without a camera the view keeps drawing everything, as it always has
+      if (!frusta[view]) {
+        for (uint32_t i = begin; i < end; ++i) masks[i] |= viewBit;
+        continue;
+      }
+      FrustumCuller::cull(*frusta[view], range, end - begin, viewBit, masks + begin);
+    }
+
+    for (uint32_t i = begin; i < end; ++i)
+      draws[i].viewMask = masks[i];
+  });
+}
+
+void SceneExtractor::buildBatches(RenderContext &context, FrameArena &arena) {
+  ArenaArray<MeshDraw> &draws = frameSnapshot.meshDraws;
+  if (draws.empty()) return;
+
+  // Group draws by geometry, keeping slots ascending within a group
+  auto drawKey = [](const MeshDraw &d) {
+    // Layout first so each pipeline variant is bound once per frame
+    return std::make_tuple(d.mesh.vertexLayout, d.mesh.vertexBuffer, d.mesh.indexBuffer,
+                           d.mesh.firstIndex, d.mesh.vertexOffset, d.objectIndex);
+  };
+  std::sort(draws.begin(), draws.end(), [&](const MeshDraw &a, const MeshDraw &b) {
+    return drawKey(a) < drawKey(b);
+  });
+
+  uint32_t instanceCount = 0;
+  for (const MeshDraw &draw : draws)
+    instanceCount += static_cast<uint32_t>(std::popcount(draw.viewMask));
+  if (instanceCount == 0) return;
+
+  // Every view gets its own batches and range of instance slots
+  uint32_t *instanceSlots = context.mapInstanceSlots(FrameInfo::frameIndex, instanceCount);
+  ArenaArray<uint32_t> visible = arena.allocArray<uint32_t>(draws.size());
+  uint32_t offset = 0;
+  for (uint32_t view = 0; view < CAMERA_SOURCE_COUNT; ++view) {
+    visible.clear();
+    for (uint32_t i = 0; i < draws.size(); ++i)
+      if (draws[i].viewMask & (1u << view)) visible.push_back(i);
+
+    // One batch per geometry; firstInstance temporarily indexes into visible
+    ArenaArray<DrawBatch> &batches = frameSnapshot.batches[view];
+    batches = arena.allocArray<DrawBatch>(visible.size());
+    for (uint32_t v = 0; v < visible.size(); ++v) {
+      const MeshProxy &mesh = draws[visible[v]].mesh;
+      if (!batches.empty()) {
+        DrawBatch &last = batches[batches.size() - 1];
+        if (last.mesh.vertexBuffer == mesh.vertexBuffer &&
+            last.mesh.indexBuffer == mesh.indexBuffer &&
+            last.mesh.firstIndex == mesh.firstIndex &&
+            last.mesh.vertexOffset == mesh.vertexOffset) {
+          last.instanceCount++;
+          continue;
+        }
+      }
+      batches.push_back({mesh, v, 1});
+    }
+
+    // Batches that can share a multi-draw call (same buffers and instance
+    // count) become adjacent, so their instance ranges sit at a fixed stride
+    auto batchKey = [](const DrawBatch &b) {
+      return std::make_tuple(b.mesh.vertexLayout, b.mesh.vertexBuffer, b.mesh.indexBuffer,
+                             b.instanceCount, b.mesh.firstIndex, b.mesh.vertexOffset);
+    };
+    std::sort(batches.begin(), batches.end(), [&](const DrawBatch &a, const DrawBatch &b) {
+      return batchKey(a) < batchKey(b);
+    });
+
+    for (DrawBatch &batch : batches) {
+      for (uint32_t i = 0; i < batch.instanceCount; ++i)
+        instanceSlots[offset + i] = draws[visible[batch.firstInstance + i]].objectIndex;
+      batch.firstInstance = offset;
+      offset += batch.instanceCount;
+    }
+  }
+}
+
+} // namespace Magma
@@ -0,0 +1,72 @@
+#pragma once
+#include "core/frustum.hpp"
+#include "core/render_proxy.hpp"
+#include "engine/render/frame_snapshot.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Magma {
+
+class FrameArena;
+class GameObject;
+class ObjectTable;
+class RenderContext;
+class Scene;
+
+/**
+ * Runs the single per-frame extraction pass over the active scene.
+ * The scene's systems run first: transform propagation, then component
+ * updates, scheduled across the JobSystem. Render proxies are then
+ * gathered by linear scans over the scene's Mesh and PointLight pools.
+ * Changed transforms go to the persistent ObjectTable, lights are written
+ * straight into the frame's mapped light buffer and draws into the frame
+ * arena.
+ * Each draw then picks the coarsest LOD whose projected error stays below
+ * LOD_SCREEN_ERROR and is frustum culled against every camera, both in
+ * parallel ranges of draws. The draws
+ * each camera sees are grouped into instanced batches, ordered so batches
+ * sharing buffers can be submitted as one multi-draw. The resulting
+ * FrameSnapshot is consumed by all SceneRenderers.
+ */
+class SceneExtractor {
+public:
+  /** Largest projected LOD error, in screen heights (about a pixel at 1080p) */
+  static constexpr float LOD_SCREEN_ERROR = 1.f / 1080.f;
+  /** A coarser LOD is only taken below this fraction of LOD_SCREEN_ERROR */
+  static constexpr float LOD_HYSTERESIS = 0.6f;
+
+  SceneExtractor() = default;
+
+  SceneExtractor(const SceneExtractor &) = delete;
+  SceneExtractor &operator=(const SceneExtractor &) = delete;
+
+  const FrameSnapshot &extract(Scene *scene, RenderContext &context, FrameArena &arena);
+  const FrameSnapshot &snapshot() const { return frameSnapshot; }
+
+  static void setEditorCameraProxy(const RenderProxy &proxy) {
+    editorCameraProxy = proxy;
+  }
+
+private:
+  FrameSnapshot frameSnapshot;
+
+  void extractScene(Scene &scene, ObjectTable &objectTable, FrameArena &arena);
+  void extractDraw(const GameObject &go, const RenderProxy &proxy, ObjectTable &objectTable);
+  void selectLods();
+  void cullViews(FrameArena &arena);
+  void buildBatches(RenderContext &context, FrameArena &arena);
+
+  // Last LOD per ObjectTable slot; key tells a reused slot from its old owner
+  struct LodState {
+    uint64_t key = 0;
+    uint8_t lod = 0;
+  };
+  std::vector<LodState> lodStates;
+
+  // World bounds of this frame's draws in extraction order, in the frame arena
+  CullBounds bounds;
+
+  inline static RenderProxy editorCameraProxy = {};
+};
+
+} // namespace Magma
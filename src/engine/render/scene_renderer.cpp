@@ -81,7 +81,7 @@ void SceneRenderer::destroy() {
   cameraLayout.reset();
   cameraPool.reset();   // frees pool and all sets allocated from it
 
-  pipeline.reset();
+  for (auto &pipeline : pipelines) pipeline.reset();
 
   if (pipelineLayout != VK_NULL_HANDLE) {
     vkDestroyPipelineLayout(Device::get().device(), pipelineLayout, nullptr);
@@ -113,28 +113,22 @@ void SceneRenderer::onResize(const VkExtent2D newExtent) {
   #endif
 }
 
-namespace {
-constexpr uint32_t kMaxPointLights =
-    sizeof(PointLightSSBO::lights) / sizeof(PointLightData);
-} // namespace
-
 void SceneRenderer::onRender() {
   begin();
   record();
 
-  syncActiveCameraAspect();
-  FrameSceneData data = collectFrameData();
-  uploadFrameData(data);
-
-  for (const auto &draw : data.meshDraws)
-    RenderCallback::renderMesh(draw.mesh, draw.objectIndex);
+  if (view.snapshot) {
+    const auto &batches = view.snapshot->batches[static_cast<uint32_t>(cameraSource)];
+    RenderCallback::renderBatches(*this, batches.data(), batches.size());
+  }
 
   end();
 }
 
 void SceneRenderer::syncActiveCameraAspect() {
   if (cameraSource != CameraSource::Scene) return;
-  GameObject *activeCam = SceneManager::activeScene->activeCamera;
+  if (!SceneManager::activeScene) return;
+  GameObject *activeCam = SceneManager::activeScene->getActiveCamera();
   if (!activeCam) return;
 
   auto *cam = activeCam->getComponent<Camera>();
@@ -144,48 +138,12 @@ void SceneRenderer::syncActiveCameraAspect() {
   cam->setAspectRatio(static_cast<float>(ext.width) / static_cast<float>(ext.height));
 }
 
-SceneRenderer::FrameSceneData SceneRenderer::collectFrameData() {
-  FrameSceneData data;
-  GameObject *activeCam = SceneManager::activeScene->activeCamera;
-
-  for (auto &go : SceneManager::activeScene->getGameObjects()) {
-    go->onUpdate();
-    auto proxy = go->collectProxies();
-
-    uint32_t idx = 0;
-    if (proxy.mesh && proxy.transform) {
-      data.objects.objects[idx] = {
-          .modelMatrix = proxy.transform->modelMatrix,
-          .normalMatrix = proxy.transform->normalMatrix,
-          .objectID = proxy.transform->objectId,
-      };
-      data.meshDraws.push_back({*proxy.mesh, idx});
-      idx++;
-    }
-
-    if (proxy.pointLight && data.lights.lightCount < kMaxPointLights) {
-      data.lights.lights[data.lights.lightCount] = {
-          proxy.pointLight->position,
-          proxy.pointLight->color,
-      };
-      data.lights.lightCount++;
-    }
-
-    if (proxy.camera && go.get() == activeCam)
-      data.sceneCamera = *proxy.camera;
-  }
-
-  return data;
-}
-
-void SceneRenderer::uploadFrameData(const FrameSceneData &data) {
-  renderContext->updateObjects(FrameInfo::frameIndex, &data.objects, sizeof(data.objects));
-  renderContext->updatePointLights(FrameInfo::frameIndex, &data.lights, sizeof(data.lights));
+void SceneRenderer::prepareView(const FrameSnapshot &snapshot) {
+  view.snapshot = &snapshot;
+  view.camera = snapshot.camera(cameraSource);
 
-  if (cameraSource == CameraSource::Scene && data.sceneCamera)
-    uploadCameraUBO({data.sceneCamera->projView});
-  else if (cameraSource == CameraSource::Editor && editorCameraProxy.camera)
-    uploadCameraUBO({editorCameraProxy.camera->projView});
+  if (view.camera)
+    uploadCameraUBO({view.camera->projView});
 }
 
 SwapChain* SceneRenderer::getSwapChain() const {
@@ -236,7 +194,9 @@ void SceneRenderer::begin() {
   for (auto &feature : renderFeatures)
     feature->prepare(idx);
 
-  std::vector<VkRenderingAttachmentInfo> colors{};
+  // Reused across frames to keep the frame loop allocation free
+  std::vector<VkRenderingAttachmentInfo> &colors = colorAttachments;
+  colors.clear();
   colors.emplace_back(renderTarget->getColorAttachment(idx));
   for (auto &feature : renderFeatures)
     feature->pushColorAttachments(colors, idx);
@@ -269,8 +229,12 @@ void SceneRenderer::begin() {
   vkCmdSetScissor(FrameInfo::commandBuffer, 0, 1, &scissor);
 }
 
+void SceneRenderer::bindPipeline(VertexLayout layout) {
+  pipelines[static_cast<size_t>(layout)]->bind(FrameInfo::commandBuffer);
+}
+
 void SceneRenderer::record() {
-  pipeline->bind(FrameInfo::commandBuffer);
+  bindPipeline(VertexLayout::Standard);
 
   VkDescriptorSet sets[] = {
       cameraDescriptorSets[FrameInfo::frameIndex],
@@ -392,8 +356,12 @@ void SceneRenderer::createPipeline() {
   }
   pipelineConfigInfo.depthFormat = renderTarget->getDepthFormat();
 
-  pipeline.reset();
-  pipeline = make_unique<Pipeline>(shaderInfo.vertFile, shaderInfo.fragFile, pipelineConfigInfo);
+  for (size_t layout = 0; layout < VERTEX_LAYOUT_COUNT; ++layout) {
+    pipelineConfigInfo.vertexLayout = static_cast<VertexLayout>(layout);
+    pipelines[layout].reset();
+    pipelines[layout] = make_unique<Pipeline>(shaderInfo.vertFile, shaderInfo.fragFile,
+                                              pipelineConfigInfo);
+  }
 }
 
 } // namespace Magma
@@ -10,6 +10,7 @@
 #include "engine/components/camera.hpp"
 #include "engine/components/point_light.hpp"
 #include "engine/render/features/render_feature.hpp"
+#include "engine/render/frame_snapshot.hpp"
 #include "engine/render/render_context.hpp"
 #include <array>
 #include <memory>
@@ -23,11 +24,6 @@
 
 namespace Magma {
 
-enum class CameraSource {
-  Editor,
-  Scene
-};
-
 class SceneRenderer : public IRenderer {
 public:
   SceneRenderer(std::unique_ptr<IRenderTarget> target, PipelineShaderInfo &shaderInfo);
@@ -58,9 +54,8 @@ public:
   void addRenderFeature(std::unique_ptr<RenderFeature> feature);
 
   CameraSource cameraSource = CameraSource::Editor;
-  static void setEditorCameraProxy(const RenderProxy &proxy) {
-    editorCameraProxy = proxy;
-  }
+  void syncActiveCameraAspect();
+  void prepareView(const FrameSnapshot &snapshot);
 
   #if defined(MAGMA_WITH_EDITOR)
     void createSceneTextures();
@@ -70,6 +65,7 @@ public:
 
   VkPipelineLayout getPipelineLayout() const override {
     return pipelineLayout; }
+  void bindPipeline(VertexLayout layout) override;
 
   void onResize(const VkExtent2D newExtent) override;
   void onRender() override;
@@ -80,7 +76,8 @@ public:
   void uploadCameraUBO(const CameraUBO &ubo);
 
 private:
-  std::unique_ptr<Pipeline> pipeline = nullptr;
+  // One variant per vertex layout, differing only in vertex input state
+  std::array<std::unique_ptr<Pipeline>, VERTEX_LAYOUT_COUNT> pipelines;
   PipelineShaderInfo shaderInfo;
   void createPipeline() override;
 
@@ -96,21 +93,13 @@ private:
   void begin() override;
   void record() override;
   void end() override;
+  std::vector<VkRenderingAttachmentInfo> colorAttachments;
 
-  struct MeshDraw {
-    MeshProxy mesh;
-    uint32_t objectIndex;
-  };
-  struct FrameSceneData {
-    ObjectStorageSSBO objects{};
-    PointLightSSBO lights{};
-    std::vector<MeshDraw> meshDraws;
-    std::optional<CameraProxy> sceneCamera;
-  };
-
-  void syncActiveCameraAspect();
-  FrameSceneData collectFrameData();
-  void uploadFrameData(const FrameSceneData &data);
+  // Per-renderer view of the shared frame snapshot
+  struct ViewData {
+    const FrameSnapshot *snapshot = nullptr;
+    std::optional<CameraProxy> camera;
+  } view;
 
   RenderContext *renderContext;
   std::unique_ptr<IRenderTarget> renderTarget = nullptr;
@@ -120,8 +109,6 @@ private:
   #if defined(MAGMA_WITH_EDITOR)
     std::vector<ImTextureID> sceneTextures = {};
   #endif
-
-  inline static RenderProxy editorCameraProxy = {};
 };
 
 } // namespace Magma
@@ -258,8 +258,8 @@ void SwapchainTarget::destroyDepthResources() {
       vkDestroyImageView(device, depthImageViews[i], nullptr);
     if (depthImages[i] != VK_NULL_HANDLE)
       vkDestroyImage(device, depthImages[i], nullptr);
-    if (depthImageMemories[i] != VK_NULL_HANDLE)
-      vkFreeMemory(device, depthImageMemories[i], nullptr);
+    if (depthImageMemories[i].valid())
+      Device::freeMemory(depthImageMemories[i]);
   }
   depthImages.clear();
   depthImageViews.clear();
@@ -1,4 +1,5 @@
 #pragma once
+#include "core/memory_allocator.hpp"
 #include "core/image_transitions.hpp"
 #include "core/render_target.hpp"
 #include "core/swapchain.hpp"
@@ -51,7 +52,7 @@ private:
 
   // Depth (owned)
   std::vector<VkImage> depthImages = {VK_NULL_HANDLE};
-  std::vector<VkDeviceMemory> depthImageMemories = {VK_NULL_HANDLE};
+  std::vector<Allocation> depthImageMemories = {Allocation{}};
   std::vector<VkImageView> depthImageViews = {VK_NULL_HANDLE};
   std::vector<VkImageLayout> depthImageLayouts = {VK_IMAGE_LAYOUT_UNDEFINED};
   VkFormat depthImageFormat = VK_FORMAT_D32_SFLOAT;
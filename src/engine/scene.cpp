@@ -1,5 +1,9 @@
 #include "scene.hpp"
-#include "core/device.hpp"
+#include "components/camera.hpp"
+#include "components/mesh.hpp"
+#include "components/point_light.hpp"
+#include "components/transform.hpp"
+#include "core/job_system.hpp"
 #include "gameobject.hpp"
 #include "scene_action.hpp"
 #include <cassert>
@@ -8,46 +12,119 @@
 
 namespace Magma {
 
+namespace {
+// Ticks a pool chunk by chunk. Besides its own type, the update reads what
+// T::UpdateReads lists and stays on the main thread if T asks for it
+template <typename T>
+System componentUpdate(ComponentPool<T> &pool) {
+  System system;
+  system.writes = componentMask<T>;
+  if constexpr (requires { typename T::UpdateReads; })
+    system.reads = listMask<typename T::UpdateReads>;
+  if constexpr (requires { T::UPDATE_ON_MAIN_THREAD; })
+    system.mainThread = T::UPDATE_ON_MAIN_THREAD;
+  system.count = [&pool] { return pool.size(); };
+  system.run = [&pool](uint32_t begin, uint32_t end) { pool.update(begin, end); };
+  return system;
+}
+} // namespace
+
+Scene::Scene(std::string name) : name{name} {
+  // Transforms go first, so updates reading Transform see this frame's
+  // world matrices. Update systems are only generated for types overriding
+  // onUpdate
+  transforms.addSystems(*this, systems);
+  ComponentTypes::forEach([&]<typename T>() {
+    auto pool = std::make_unique<ComponentPool<T>>();
+    if constexpr (overridesUpdate<T>) systems.add(componentUpdate(*pool));
+    pools[componentId<T>] = std::move(pool);
+  });
+}
+
 GameObject *Scene::createGameObject(){
-  auto go = std::make_unique<GameObject>();
-  GameObject *goPtr = go.get();
-  gameObjects.push_back(std::move(go));
-  return goPtr;
+  return addGameObject(std::make_unique<GameObject>());
 }
 GameObject *Scene::createGameObject(std::string name){
-  auto go = std::make_unique<GameObject>(name);
-  GameObject *goPtr = go.get();
-  gameObjects.push_back(std::move(go));
-  return goPtr;
+  return addGameObject(std::make_unique<GameObject>(name));
 }
+// Children are owned by their parent, the scene only holds root objects;
+// addChild indexes them through the parent's scene
 GameObject *Scene::createGameObject(GameObject* parent){
-  auto go = std::make_unique<GameObject>(parent);
-  GameObject *goPtr = go.get();
-  gameObjects.push_back(std::move(go));
-  return goPtr;
+  if (!parent) return createGameObject();
+  return parent->addChild(std::make_unique<GameObject>(parent));
 }
 GameObject *Scene::createGameObject(GameObject* parent, std::string name){
-  auto go = std::make_unique<GameObject>(parent, name);
-  GameObject *goPtr = go.get();
-  gameObjects.push_back(std::move(go));
-  return goPtr;
+  if (!parent) return createGameObject(name);
+  return parent->addChild(std::make_unique<GameObject>(parent, name));
 }
 
 GameObject *Scene::addGameObject(std::unique_ptr<GameObject> gameObject) {
   assert(gameObject != nullptr && "GameObject cannot be null when adding to scene");
   GameObject *ref = gameObject.get();
   gameObjects.push_back(std::move(gameObject));
+  track(ref);
   return ref;
 }
 void Scene::removeGameObject(GameObject *gameObject) {
-  defer(SceneAction::remove(gameObject));
+  if (gameObject) defer(SceneAction::remove(gameObject->handle));
+}
+
+GameObject *Scene::findGameObject(GameObject::id_t id) const {
+  auto it = objectIndex.find(id);
+  return it != objectIndex.end() ? it->second : nullptr;
+}
+
+void Scene::updateSystems() {
+  systems.run(JobSystem::get());
+}
+
+void Scene::track(GameObject *gameObject) {
+  if (!gameObject) return;
+  uint32_t index;
+  if (!freeObjectSlots.empty()) {
+    index = freeObjectSlots.back();
+    freeObjectSlots.pop_back();
+  } else {
+    index = static_cast<uint32_t>(objectSlots.size());
+    objectSlots.emplace_back();
+  }
+  objectSlots[index].object = gameObject;
+  gameObject->handle = {index, objectSlots[index].generation};
+  gameObject->scene = this;
+  objectIndex[gameObject->id] = gameObject;
+
+  // Components move from the object into the packed pools
+  for (uint32_t typeId = 0; typeId < COMPONENT_TYPE_COUNT; ++typeId)
+    if (auto &component = gameObject->components[typeId])
+      pools[typeId]->adopt(index, std::move(component));
+
+  gameObject->forEachChild([&](GameObject *child) { track(child); });
+}
+
+void Scene::untrack(GameObject *gameObject) {
+  if (!gameObject) return;
+  gameObject->forEachChild([&](GameObject *child) { untrack(child); });
+  objectIndex.erase(gameObject->id);
+  if (resolve(gameObject->handle)) {
+    for (uint32_t typeId = 0; typeId < COMPONENT_TYPE_COUNT; ++typeId)
+      gameObject->components[typeId] = pools[typeId]->release(gameObject->handle.index);
+
+    ObjectSlot &slot = objectSlots[gameObject->handle.index];
+    slot.object = nullptr;
+    if (++slot.generation == 0) slot.generation = 1;
+    freeObjectSlots.push_back(gameObject->handle.index);
+  }
+  gameObject->handle = {};
+  gameObject->scene = nullptr;
 }
 
 void Scene::processDeferredActions() {
   if (deferredActions.empty())
     return;
 
-  Device::waitIdle();
+  // Runs once the frame is submitted, before the frame index advances, when
+  // no snapshot refers to the objects; their GPU resources are retired
+  // through the DeletionQueue slot of the frame that last used them
   for (auto &action : deferredActions)
     action();
   deferredActions.clear();
@@ -1,20 +1,47 @@
 #pragma once
+#include "component_pool.hpp"
+#include "components/component_registry.hpp"
 #include "gameobject.hpp"
+#include "system_scheduler.hpp"
+#include "transform_system.hpp"
+#include <array>
 #include <functional>
 #include <memory>
+#include <span>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace Magma {
 
+class Scene;
+
+/**
+ * Objects of a Scene having all of Ts, visited with their components.
+ * Iteration walks the smallest of the pools, in packed order.
+ */
+template <typename... Ts>
+class SceneView {
+public:
+  SceneView(const Scene &scene, ComponentPool<Ts> *...pools) : scene{scene}, pools{pools...} {}
+
+  /** Calls visit(GameObject &, Ts &...); must not add or remove Ts */
+  template <typename F>
+  void each(F &&visit) const;
+
+private:
+  const Scene &scene;
+  std::tuple<ComponentPool<Ts> *...> pools;
+};
+
 class Scene {
 public:
-  Scene(std::string name): name{name}{}
+  Scene(std::string name);
   ~Scene() {}
 
+  // Objects and systems point back at their scene, so it stays in place
   Scene(const Scene &) = delete;
   Scene &operator=(const Scene &) = delete;
-  Scene(Scene &&) = default;
-  Scene &operator=(Scene &&) = default;
 
   std::vector<std::unique_ptr<GameObject>> &getGameObjects() { return gameObjects; }
   std::string getName(){
@@ -30,15 +57,90 @@ public:
   GameObject *addGameObject(std::unique_ptr<GameObject> gameObject);
   void removeGameObject(GameObject *gameObject);
 
+  /** Constant time lookup of any object in the scene, children included */
+  GameObject *findGameObject(GameObject::id_t id) const;
+  /** The object a handle refers to, or nullptr once it has been destroyed */
+  GameObject *resolve(ObjectHandle handle) const {
+    if (handle.index >= objectSlots.size()) return nullptr;
+    const ObjectSlot &slot = objectSlots[handle.index];
+    return slot.generation == handle.generation ? slot.object : nullptr;
+  }
+  bool isValid(ObjectHandle handle) const { return resolve(handle) != nullptr; }
+  /** Objects in the scene, children included */
+  uint32_t objectCount() const { return static_cast<uint32_t>(objectIndex.size()); }
+  /** Indexes an object and its subtree as they join the scene */
+  void track(GameObject *gameObject);
+  /** Drops an object and its subtree from the index before they are destroyed */
+  void untrack(GameObject *gameObject);
+
+  // Components
+  ComponentPoolBase *findPool(uint32_t typeId) const { return pools[typeId].get(); }
+  template <typename T>
+  ComponentPool<T> *findPool() const {
+    return static_cast<ComponentPool<T> *>(findPool(componentId<T>));
+  }
+  template <typename... Ts>
+  SceneView<Ts...> view() const {
+    return SceneView<Ts...>{*this, findPool<Ts>()...};
+  }
+  /** Visits every component of one object, one pool after another */
+  template <typename F>
+  void forEachComponent(ObjectHandle handle, F &&visit) const {
+    for (const auto &pool : pools)
+      if (pool)
+        if (Component *component = pool->get(handle.index)) visit(*component);
+  }
+  /** Runs this frame's systems: transforms, component updates, then user systems */
+  void updateSystems();
+  /** Scheduler user systems are added to */
+  SystemScheduler &getSystems() { return systems; }
+  GameObject *objectAt(uint32_t slot) const { return objectSlots[slot].object; }
+
   void defer(std::function<void()> func) { deferredActions.push_back(func); }
   void processDeferredActions();
 
-  inline static GameObject *activeCamera = nullptr;
+  ObjectHandle activeCamera;
+  GameObject *getActiveCamera() const { return resolve(activeCamera); }
 
 private:
   std::string name;
   std::vector<std::unique_ptr<GameObject>> gameObjects;
+  std::unordered_map<GameObject::id_t, GameObject *> objectIndex;
+
+  // Slot map behind ObjectHandles; a slot's generation moves on when its
+  // object leaves the scene, invalidating every handle to it
+  struct ObjectSlot {
+    GameObject *object = nullptr;
+    uint32_t generation = 1;
+  };
+  std::vector<ObjectSlot> objectSlots;
+  std::vector<uint32_t> freeObjectSlots;
+
+  // One pool per registered component type, indexed by componentId and
+  // destroyed before the objects owning them
+  std::array<std::unique_ptr<ComponentPoolBase>, COMPONENT_TYPE_COUNT> pools;
+
+  SystemScheduler systems;
+  TransformSystem transforms;
+
   std::vector<std::function<void()>> deferredActions;
 };
 
+template <typename... Ts>
+template <typename F>
+void SceneView<Ts...>::each(F &&visit) const {
+  if ((!std::get<ComponentPool<Ts> *>(pools) || ...)) return;
+
+  std::span<const uint32_t> slots = std::get<0>(pools)->objectSlots();
+  ((slots = std::get<ComponentPool<Ts> *>(pools)->size() < slots.size()
+                ? std::get<ComponentPool<Ts> *>(pools)->objectSlots()
+                : slots),
+   ...);
+
+  for (uint32_t slot : slots) {
+    if (!(std::get<ComponentPool<Ts> *>(pools)->contains(slot) && ...)) continue;
+    visit(*scene.objectAt(slot), *std::get<ComponentPool<Ts> *>(pools)->find(slot)...);
+  }
+}
+
 } // namespace Magma
@@ -1,5 +1,4 @@
 #pragma once
-#include "engine/components/mesh.hpp"
 #include "engine/gameobject.hpp"
 #include "engine/scene_manager.hpp"
 #include <algorithm>
@@ -9,14 +8,18 @@ namespace Magma {
 
 class SceneAction {
 public:
-  inline static std::function<void()> remove(GameObject *obj) {
-    return [obj]() {
+  /** Destroys the object and its children, unless it is already gone */
+  inline static std::function<void()> remove(ObjectHandle handle) {
+    return [handle]() {
+      Scene *scene = SceneManager::activeScene;
+      GameObject *obj = scene ? scene->resolve(handle) : nullptr;
       if (!obj) return;
 
       if (obj->parent) {
         obj->parent->removeChild(obj);
-      } else if (SceneManager::activeScene) {
-        auto &gameObjects = SceneManager::activeScene->getGameObjects();
+      } else {
+        scene->untrack(obj);
+        auto &gameObjects = scene->getGameObjects();
         gameObjects.erase(
             std::remove_if(gameObjects.begin(), gameObjects.end(),
                            [&](const auto &go) { return go.get() == obj; }),
@@ -24,12 +27,6 @@ public:
       }
     };
   }
-
-  inline static std::function<void()> loadMesh(Mesh *mesh) {
-    return [mesh]() {
-      if (mesh) mesh->load();
-    };
-  }
 };
 
 } // namespace Magma
@@ -28,6 +28,11 @@ public:
   }
 
   static GameObject *findGameObjectById(uint64_t id);
+
+  /** Resolves a handle against the active scene */
+  static GameObject *resolve(ObjectHandle handle) {
+    return activeScene ? activeScene->resolve(handle) : nullptr;
+  }
 };
 
 } // namespace Magma
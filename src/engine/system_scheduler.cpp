@@ -0,0 +1,111 @@
+#include "system_scheduler.hpp"
+#include "core/job_system.hpp"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace Magma {
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void SystemScheduler::add(System system) {
+  assert(system.run && "System needs a run function!");
+  assert(system.chunkSize > 0 && "System chunk size must be positive!");
+  nodes.push_back({std::move(system)});
+  graphDirty = true;
+}
+
+void SystemScheduler::run(JobSystem &jobs) {
+  if (graphDirty) buildGraph();
+  if (nodes.empty()) return;
+
+  failed.store(false, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < size(); ++i)
+    states[i].dependencies.store(nodes[i].dependencies, std::memory_order_relaxed);
+
+  // Jobs submit their dependents on the same counter before finishing, so
+  // it only reaches zero once the last system is done
+  JobCounter counter;
+  for (uint32_t i = 0; i < size(); ++i)
+    if (nodes[i].dependencies == 0) dispatch(i, jobs, counter);
+  jobs.wait(counter);
+
+  if (std::exception_ptr firstError = std::exchange(error, nullptr))
+    std::rethrow_exception(firstError);
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+void SystemScheduler::buildGraph() {
+  // Earlier systems win conflicts, so edges only point forward
+  for (Node &node : nodes) {
+    node.dependents.clear();
+    node.dependencies = 0;
+  }
+  for (uint32_t j = 0; j < size(); ++j) {
+    const System &later = nodes[j].system;
+    for (uint32_t i = 0; i < j; ++i) {
+      const System &earlier = nodes[i].system;
+      const bool conflict = (earlier.writes & (later.reads | later.writes)) ||
+                            (earlier.reads & later.writes);
+      if (!conflict) continue;
+      nodes[i].dependents.push_back(j);
+      nodes[j].dependencies++;
+    }
+  }
+
+  states = std::make_unique<NodeState[]>(size());
+  graphDirty = false;
+}
+
+void SystemScheduler::dispatch(uint32_t index, JobSystem &jobs, JobCounter &counter) {
+  const System &system = nodes[index].system;
+  const uint32_t count = system.count ? system.count() : 1;
+  const uint32_t chunkCount = (count + system.chunkSize - 1) / system.chunkSize;
+
+  // Nothing to do this frame, so its dependents are ready right away
+  if (chunkCount == 0) {
+    complete(index, jobs, counter);
+    return;
+  }
+
+  states[index].chunks.store(chunkCount, std::memory_order_relaxed);
+  for (uint32_t c = 0; c < chunkCount; ++c) {
+    const uint32_t begin = c * system.chunkSize;
+    const uint32_t end = std::min(count, begin + system.chunkSize);
+    auto chunk = [this, index, begin, end, &jobs, &counter] {
+      execute(index, begin, end);
+      if (states[index].chunks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        complete(index, jobs, counter);
+    };
+    if (system.mainThread)
+      jobs.submitToMain(std::move(chunk), &counter);
+    else
+      jobs.submit(std::move(chunk), &counter);
+  }
+}
+
+void SystemScheduler::complete(uint32_t index, JobSystem &jobs, JobCounter &counter) {
+  for (uint32_t dependent : nodes[index].dependents)
+    if (states[dependent].dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      dispatch(dependent, jobs, counter);
+}
+
+void SystemScheduler::execute(uint32_t index, uint32_t begin, uint32_t end) {
+  // Once a system failed the rest only drain, so the frame still completes
+  if (failed.load(std::memory_order_relaxed)) return;
+
+  try {
+    nodes[index].system.run(begin, end);
+  } catch (...) {
+    std::lock_guard lock(errorMutex);
+    if (!error) error = std::current_exception();
+    failed.store(true, std::memory_order_relaxed);
+  }
+}
+
+} // namespace Magma
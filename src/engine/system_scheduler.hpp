@@ -0,0 +1,82 @@
+#pragma once
+#include "components/component_registry.hpp"
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Magma {
+
+class JobCounter;
+class JobSystem;
+
+/**
+ * One update stage of a scene. It works on a range of items, is split into
+ * chunks and declares the component types it reads and writes, so stages
+ * that can't race run side by side.
+ */
+struct System {
+  ComponentMask reads = 0;
+  ComponentMask writes = 0;
+  /** Items to process, asked once dependencies are done; one item if unset */
+  std::function<uint32_t()> count;
+  /** Processes items [begin, end); chunks of one stage run concurrently */
+  std::function<void(uint32_t begin, uint32_t end)> run;
+  uint32_t chunkSize = 256;
+  /** Runs on the main thread, for work that isn't thread safe */
+  bool mainThread = false;
+};
+
+/**
+ * Runs a scene's systems once per frame as a dependency graph. A system
+ * depends on every earlier one whose writes overlap what it reads or writes,
+ * or whose reads overlap what it writes; everything else runs in parallel,
+ * one job per chunk on the JobSystem. The calling thread runs jobs too
+ * until the last system is done.
+ */
+class SystemScheduler {
+public:
+  SystemScheduler() = default;
+
+  SystemScheduler(const SystemScheduler &) = delete;
+  SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+  /** Appends a system; registration order decides who runs first on conflicts */
+  void add(System system);
+  uint32_t size() const { return static_cast<uint32_t>(nodes.size()); }
+
+  /** Runs every system once; rethrows the first exception a system threw */
+  void run(JobSystem &jobs);
+
+private:
+  struct Node {
+    System system;
+    std::vector<uint32_t> dependents;
+    uint32_t dependencies = 0;
+  };
+  std::vector<Node> nodes;
+  bool graphDirty = false;
+
+  // Progress of the current run, one entry per system
+  struct NodeState {
+    std::atomic<uint32_t> dependencies{0};
+    std::atomic<uint32_t> chunks{0};
+  };
+  std::unique_ptr<NodeState[]> states;
+
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  std::atomic<bool> failed{false};
+
+  void buildGraph();
+  /** Submits the chunks of a system whose dependencies are done */
+  void dispatch(uint32_t index, JobSystem &jobs, JobCounter &counter);
+  /** Readies the dependents of a finished system */
+  void complete(uint32_t index, JobSystem &jobs, JobCounter &counter);
+  void execute(uint32_t index, uint32_t begin, uint32_t end);
+};
+
+} // namespace Magma
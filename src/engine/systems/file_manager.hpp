@@ -1,3 +1,4 @@
+#pragma once
 #include <string>
 #include <string_view>
 #include <vector>
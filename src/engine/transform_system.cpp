@@ -0,0 +1,124 @@
+#include "transform_system.hpp"
+#include "components/transform.hpp"
+#include "core/transform_kernel.hpp"
+#include "gameobject.hpp"
+#include "scene.hpp"
+#include "system_scheduler.hpp"
+
+namespace Magma {
+
+namespace {
+// Local matrices are cheap per lane, world composition walks whole subtrees
+constexpr uint32_t LOCAL_CHUNK = 1024;
+constexpr uint32_t WORLD_CHUNK = 32;
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Public Methods
+// ----------------------------------------------------------------------------
+
+void TransformSystem::addSystems(Scene &scene, SystemScheduler &scheduler) {
+  constexpr ComponentMask transforms = componentMask<Transform>;
+
+  System gatherStage;
+  gatherStage.writes = transforms;
+  gatherStage.run = [this, &scene](uint32_t, uint32_t) { gather(scene); };
+  scheduler.add(std::move(gatherStage));
+
+  System localStage;
+  localStage.writes = transforms;
+  localStage.count = [this] { return static_cast<uint32_t>(nodes.size()); };
+  localStage.run = [this](uint32_t begin, uint32_t end) { composeLocal(begin, end); };
+  localStage.chunkSize = LOCAL_CHUNK;
+  scheduler.add(std::move(localStage));
+
+  System worldStage;
+  worldStage.writes = transforms;
+  worldStage.count = [this] { return static_cast<uint32_t>(rootStarts.size() - 1); };
+  worldStage.run = [this](uint32_t begin, uint32_t end) { composeWorld(begin, end); };
+  worldStage.chunkSize = WORLD_CHUNK;
+  scheduler.add(std::move(worldStage));
+}
+
+// ----------------------------------------------------------------------------
+// Private Methods
+// ----------------------------------------------------------------------------
+
+void TransformSystem::gather(Scene &scene) {
+  nodes.clear();
+  rootStarts.clear();
+  for (auto &go : scene.getGameObjects()) {
+    if (!go) continue;
+    rootStarts.push_back(static_cast<uint32_t>(nodes.size()));
+    gatherObjects(*go, NO_PARENT, nullptr);
+  }
+  rootStarts.push_back(static_cast<uint32_t>(nodes.size()));
+
+  // Chunks of the local stage write their own range of these
+  if (models.size() < nodes.size()) {
+    models.resize(nodes.size());
+    normals.resize(nodes.size());
+  }
+  streams.resize(nodes.size() * 9);
+}
+
+void TransformSystem::gatherObjects(GameObject &go, uint32_t parent,
+                                    const Transform *parentTransform) {
+  ObjectNode node{go.getComponent<Transform>(), parentTransform, parent};
+  const uint32_t index = static_cast<uint32_t>(nodes.size());
+  nodes.push_back(node);
+
+  // Objects without a Transform pass their closest ancestor's on
+  const Transform *childParent = node.transform ? node.transform : parentTransform;
+  go.forEachChild([&](GameObject *child) {
+    gatherObjects(*child, index, childParent);
+  });
+}
+
+void TransformSystem::composeLocal(uint32_t begin, uint32_t end) {
+  // Changed transforms of the chunk are packed from lane `begin` on and
+  // built in one kernel call
+  const size_t stride = nodes.size();
+  float *stream[9];
+  for (uint32_t v = 0; v < 9; ++v) stream[v] = streams.data() + v * stride;
+
+  uint32_t lane = begin;
+  for (uint32_t i = begin; i < end; ++i) {
+    ObjectNode &node = nodes[i];
+    node.localChanged = node.transform && node.transform->syncLocal();
+    if (!node.localChanged) continue;
+    const Transform &t = *node.transform;
+    const float values[9] = {t.position.x, t.position.y, t.position.z,
+                             t.rotation.x, t.rotation.y, t.rotation.z,
+                             t.scale.x,    t.scale.y,    t.scale.z};
+    for (uint32_t v = 0; v < 9; ++v) stream[v][lane] = values[v];
+    lane++;
+  }
+  if (lane == begin) return;
+
+  TransformKernel::compose({stream[0] + begin, stream[1] + begin, stream[2] + begin,
+                            stream[3] + begin, stream[4] + begin, stream[5] + begin,
+                            stream[6] + begin, stream[7] + begin, stream[8] + begin},
+                           lane - begin, models.data() + begin, normals.data() + begin);
+  lane = begin;
+  for (uint32_t i = begin; i < end; ++i)
+    if (nodes[i].localChanged) {
+      nodes[i].transform->setLocalMatrices(models[lane], normals[lane]);
+      lane++;
+    }
+}
+
+void TransformSystem::composeWorld(uint32_t firstRoot, uint32_t lastRoot) {
+  // Parents precede their children within a root subtree, so one pass
+  // composes world matrices and unchanged subtrees cost nothing beyond
+  // the flag checks
+  for (uint32_t i = rootStarts[firstRoot]; i < rootStarts[lastRoot]; ++i) {
+    ObjectNode &node = nodes[i];
+    const bool parentChanged = node.parent != NO_PARENT && nodes[node.parent].worldChanged;
+    node.worldChanged = node.transform
+        ? node.transform->updateWorld(node.parentTransform, parentChanged, node.localChanged)
+        : parentChanged;
+  }
+}
+
+} // namespace Magma
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+namespace Magma {
+
+class GameObject;
+class Scene;
+class SystemScheduler;
+class Transform;
+
+/**
+ * Transform propagation of one Scene, run as three scheduled stages.
+ * Objects are gathered in hierarchy order, the local matrices of changed
+ * transforms are rebuilt in SIMD batches, one per chunk, and world matrices
+ * of changed subtrees are composed root subtree by root subtree, so both
+ * matrix stages spread over the JobSystem.
+ */
+class TransformSystem {
+public:
+  TransformSystem() = default;
+
+  TransformSystem(const TransformSystem &) = delete;
+  TransformSystem &operator=(const TransformSystem &) = delete;
+
+  /** Adds the stages to the scene's scheduler, in the order they must run */
+  void addSystems(Scene &scene, SystemScheduler &scheduler);
+
+private:
+  static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+  // One per object in depth first order, so parents precede their children
+  struct ObjectNode {
+    Transform *transform = nullptr;
+    const Transform *parentTransform = nullptr; // closest ancestor's
+    uint32_t parent = NO_PARENT;
+    bool localChanged = false;
+    bool worldChanged = false;
+  };
+
+  // Kept across frames, so steady state propagation doesn't allocate
+  std::vector<ObjectNode> nodes;
+  std::vector<uint32_t> rootStarts; // first node of each root subtree, then nodes.size()
+  std::vector<float> streams;       // 9 SoA streams of nodes.size() floats
+  std::vector<glm::mat4> models;
+  std::vector<glm::mat3x4> normals;
+
+  void gather(Scene &scene);
+  void gatherObjects(GameObject &go, uint32_t parent, const Transform *parentTransform);
+  void composeLocal(uint32_t begin, uint32_t end);
+  void composeWorld(uint32_t firstRoot, uint32_t lastRoot);
+};
+
+} // namespace Magma
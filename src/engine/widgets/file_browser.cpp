@@ -1,27 +1,56 @@
 #include "file_browser.hpp"
+#include "core/job_system.hpp"
 #include "engine/systems/file_manager.hpp"
 #include "engine/widgets/ui_context.hpp"
 #include "imgui.h"
 
 namespace Magma {
 
+namespace {
+// Picks up changes made outside the editor
+constexpr std::chrono::seconds REFRESH_INTERVAL{1};
+} // namespace
+
 void FileBrowser::draw() {
   UIContext::ensureInit();
 
+  const auto now = std::chrono::steady_clock::now();
+  if (pending && pending->ready.load(std::memory_order_acquire)) {
+    listing = std::move(pending);
+    listedAt = now;
+  }
+  const bool stale = !listing || listing->path != currentPath || now - listedAt > REFRESH_INTERVAL;
+  if (!pending && stale) requestListing();
+
   ImGui::SetNextWindowClass(&UIContext::AppDockClass);
   ImGui::Begin(name());
 
-  for (File &file: FileManager::getFiles(currentPath)) {
-    ImGui::Selectable(file.name.c_str());
-
+  // The previous directory stays up until the new one is listed
+  if (listing) {
+    for (File &file: listing->files) {
+      ImGui::Selectable(file.name.c_str());
 
-    if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
-      if (file.isDirectory())
-        currentPath = file.path;
+      if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
+        if (file.isDirectory())
+          currentPath = file.path;
+      }
     }
   }
 
   ImGui::End();
 }
 
+void FileBrowser::requestListing() {
+  pending = std::make_shared<Listing>();
+  pending->path = currentPath;
+  JobSystem::get().submit([listing = pending] {
+    try {
+      listing->files = FileManager::getFiles(listing->path);
+    } catch (const std::filesystem::filesystem_error &) {
+      // Gone or unreadable, shown as empty
+    }
+    listing->ready.store(true, std::memory_order_release);
+  });
+}
+
 } // namespace Magma
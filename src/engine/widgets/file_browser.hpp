@@ -1,7 +1,12 @@
 #pragma once
+#include "engine/systems/file_manager.hpp"
 #include "widget.hpp"
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Magma {
 
@@ -17,6 +22,18 @@ public:
 
 private:
   std::string currentPath = std::filesystem::current_path();
+
+  // Directory contents, listed by a job so slow disks never stall the UI
+  struct Listing {
+    std::string path;
+    std::vector<File> files;
+    std::atomic<bool> ready = false;
+  };
+  std::shared_ptr<Listing> listing; // drawn
+  std::shared_ptr<Listing> pending; // being listed
+  std::chrono::steady_clock::time_point listedAt;
+
+  void requestListing();
 };
 
 } // namespace Magma
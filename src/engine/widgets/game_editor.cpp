@@ -2,8 +2,9 @@
 #include "core/frame_info.hpp"
 #include "engine/components/transform.hpp"
 #include "engine/editor_camera.hpp"
-#include "engine/render/scene_renderer.hpp"
+#include "engine/render/scene_extractor.hpp"
 #include "engine/render/viewport.hpp"
+#include "engine/scene_manager.hpp"
 #include "engine/time.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
@@ -102,10 +103,10 @@ void GameEditor::draw() {
       editorCamera.moveUp(-cameraSpeed);
   }
 
-  // Update editor camera and push proxy to scene renderer
+  // Update editor camera and push proxy to the scene extractor
   editorCamera.onUpdate();
   RenderProxy proxy = editorCamera.collectProxy();
-  SceneRenderer::setEditorCameraProxy(proxy);
+  SceneExtractor::setEditorCameraProxy(proxy);
 
   ImVec2 avail = ImGui::GetContentRegionAvail();
   ImVec2 imgSize = fit16x9(avail);
@@ -136,7 +137,7 @@ void GameEditor::draw() {
   }
 
   if (ImGui::IsMouseReleased(ImGuiMouseButton_Left)) {
-    draggedObject = nullptr;
+    draggedObject = {};
     dragPixelOffset = ImVec2{0, 0};
     dragStartMousePos = ImVec2{0, 0};
   }
@@ -150,7 +151,7 @@ void GameEditor::draw() {
 
 void GameEditor::beginDrag(GameObject *picked, const ImVec2 &mousePos,
                            const ImVec2 &imageMin, const ImVec2 &imageSize) {
-  draggedObject = picked;
+  draggedObject = picked->handle;
   dragStartMousePos = mousePos;
   dragStartImageMin = imageMin;
   dragStartImageSize = imageSize;
@@ -163,7 +164,8 @@ void GameEditor::beginDrag(GameObject *picked, const ImVec2 &mousePos,
     return;
   }
 
-  dragStartWorldPos = t->position;
+  // Transforms are parent relative, the drag works in world space
+  dragStartWorldPos = t->worldPosition();
 
   glm::mat4 proj = editorCamera.getProjection();
   glm::mat4 view = editorCamera.getView();
@@ -192,7 +194,8 @@ void GameEditor::beginDrag(GameObject *picked, const ImVec2 &mousePos,
 }
 
 void GameEditor::handleMouseDrag() {
-  if (!draggedObject)
+  GameObject *dragged = SceneManager::resolve(draggedObject);
+  if (!dragged)
     return;
 
   ImGuiIO &io = ImGui::GetIO();
@@ -231,8 +234,18 @@ void GameEditor::handleMouseDrag() {
 
   glm::vec3 worldPos = glm::vec3(worldH) / worldH.w;
 
-  if (auto t = draggedObject->getComponent<Transform>())
-    t->position = worldPos;
+  auto t = dragged->getComponent<Transform>();
+  if (!t)
+    return;
+
+  // Back into the space of the closest ancestor with a Transform
+  for (GameObject *ancestor = dragged->parent; ancestor; ancestor = ancestor->parent) {
+    if (auto parentTransform = ancestor->getComponent<Transform>()) {
+      worldPos = glm::vec3(glm::inverse(parentTransform->worldMatrix()) * glm::vec4(worldPos, 1.f));
+      break;
+    }
+  }
+  t->position = worldPos;
 }
 
 } // namespace Magma
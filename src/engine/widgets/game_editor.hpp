@@ -36,7 +36,7 @@ private:
   EditorCamera editorCamera;
 
   // Drag state
-  GameObject *draggedObject = nullptr;
+  ObjectHandle draggedObject;
   ImVec2 dragStartMousePos{0,0};
   ImVec2 dragStartImageMin{0,0};
   ImVec2 dragStartImageSize{0,0};
@@ -1,5 +1,6 @@
 #include "inspector.hpp"
 #include "../gameobject.hpp"
+#include "../scene_manager.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include "inspector_menu.hpp"
@@ -28,8 +29,9 @@ void Inspector::draw() {
   ImGui::SetNextWindowClass(&UIContext::AppDockClass);
   ImGui::Begin(name());
 
-  // Early out if no target
-  if (!contextTarget) {
+  // Early out if no target, or it was destroyed
+  GameObject *target = SceneManager::resolve(contextTarget);
+  if (!target) {
     resetLayoutState();
     ImGui::TextDisabled("No target selected");
     ImGui::End();
@@ -43,15 +45,13 @@ void Inspector::draw() {
       ImGuiHoveredFlags_NoPopupHierarchy;
 
   if (ImGui::IsMouseClicked(ImGuiMouseButton_Right) && ImGui::IsWindowHovered(hoveredFlags)) 
-    InspectorMenu::queueContextMenuFor(contextTarget);
+    InspectorMenu::queueContextMenuFor(target);
 
   // Header
-  ImGui::TextDisabled("Object: %s", contextTarget->name.c_str());
+  ImGui::TextDisabled("Object: %s", target->name.c_str());
 
   // Gather components 
-  vector<Component *> components;
-  if (contextTarget)
-    components = contextTarget->getComponents();
+  vector<Component *> components = target->getComponents();
 
   // Early out if no components
   if (components.empty()) {
@@ -17,9 +17,11 @@ public:
 
   /**
    * Set the context GameObject to inspect
-   * @note Passing nullptr clears the inspector
+   * @note Passing nullptr clears the inspector, as does destroying the object
    */
-  static void setContext(GameObject *obj) { contextTarget = obj; }
+  static void setContext(GameObject *obj) {
+    contextTarget = obj ? obj->handle : ObjectHandle{};
+  }
 
   // --- Rendering & Drawing ---
   /**
@@ -45,15 +47,15 @@ private:
   InspectorMenu inspectorMenu = {};
 
   /** The current GameObject displayed */
-  inline static GameObject *contextTarget = nullptr;
+  inline static ObjectHandle contextTarget = {};
 
   // Inspector Layout State
-  GameObject *lastTarget = nullptr;
+  ObjectHandle lastTarget = {};
   int lastCount = 0;
   float lastTotalHeight = 0.0f;
   float lastTotalWidth = 0.0f;
   void resetLayoutState() {
-    lastTarget = nullptr;
+    lastTarget = {};
     lastCount = 0;
     lastTotalHeight = 0.0f;
     lastTotalWidth = 0.0f;
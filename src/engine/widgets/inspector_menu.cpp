@@ -11,6 +11,11 @@
 using namespace std;
 namespace Magma {
 
+void InspectorMenu::queueContextMenuFor(GameObject *target) {
+  contextTarget = target ? target->handle : ObjectHandle{};
+  openPopupRequested = true;
+}
+
 // Draw: Popup menu for scene
 void InspectorMenu::draw() {
   if (openPopupRequested) {
@@ -20,10 +25,10 @@ void InspectorMenu::draw() {
 
   // Popup menu
   if (ImGui::BeginPopup(name())) {
-    if (contextTarget) {
-      ImGui::TextUnformatted(contextTarget->name.c_str());
+    if (GameObject *target = SceneManager::resolve(contextTarget)) {
+      ImGui::TextUnformatted(target->name.c_str());
       ImGui::Separator();
-      drawAddComponentMenu();
+      drawAddComponentMenu(target);
     } else {
       ImGui::TextUnformatted(SceneManager::activeScene->getName().c_str());
       ImGui::Separator();
@@ -41,17 +46,17 @@ void InspectorMenu::draw() {
   }
 }
 
-void InspectorMenu::drawAddComponentMenu() {
-  if (!contextTarget)
+void InspectorMenu::drawAddComponentMenu(GameObject *target) {
+  if (!target)
     return;
 
   if (ImGui::BeginMenu("Add Component")) {
     if (ImGui::MenuItem("Transform"))
-      contextTarget->addComponent<Transform>();
+      target->addComponent<Transform>();
     if (ImGui::MenuItem("Mesh"))
-      contextTarget->addComponent<Mesh>();
+      target->addComponent<Mesh>();
     if (ImGui::MenuItem("Point Light"))
-      contextTarget->addComponent<PointLight>();
+      target->addComponent<PointLight>();
     ImGui::EndMenu();
   }
 }
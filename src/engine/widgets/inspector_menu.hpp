@@ -1,5 +1,6 @@
 #pragma once
 
+#include "engine/object_handle.hpp"
 #include "widget.hpp"
 namespace Magma {
 
@@ -15,18 +16,15 @@ public:
   /**
    * Queue opening Menu 
    */
-  static void queueContextMenuFor(GameObject *target) {
-    contextTarget = target;
-    openPopupRequested = true;
-  }
+  static void queueContextMenuFor(GameObject *target);
 
   // Render
   void draw() override;
 
 private:
-  inline static GameObject *contextTarget = nullptr;
+  inline static ObjectHandle contextTarget = {};
   inline static bool openPopupRequested = false;
 
-  void drawAddComponentMenu();
+  void drawAddComponentMenu(GameObject *target);
 };
 } // namespace Magma
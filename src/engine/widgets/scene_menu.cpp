@@ -10,6 +10,14 @@
 using namespace std;
 namespace Magma {
 
+GameObject *SceneMenu::getContextTarget() {
+  return SceneManager::resolve(contextTarget);
+}
+
+void SceneMenu::setContextTarget(GameObject *gameObject) {
+  contextTarget = gameObject ? gameObject->handle : ObjectHandle{};
+}
+
 // Draw: Popup menu for scene
 void SceneMenu::draw() {
   if (openPopupRequested) {
@@ -25,7 +33,7 @@ void SceneMenu::draw() {
       if (ImGui::MenuItem("Add Child"))
         target->addChild();
       if (ImGui::MenuItem("Delete"))
-        SceneManager::activeScene->defer(SceneAction::remove(target));
+        SceneManager::activeScene->defer(SceneAction::remove(target->handle));
     } else {
       ImGui::TextUnformatted("Scene");
       ImGui::Separator();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "engine/object_handle.hpp"
 #include "widget.hpp"
 namespace Magma {
 
@@ -10,16 +11,14 @@ public:
   const char *name() const override { return "Scene Menu"; }
 
   // Getters
-  static GameObject *getContextTarget() { return contextTarget; }
+  static GameObject *getContextTarget();
 
   // Setters
-  static void setContextTarget(GameObject *gameObject) {
-    contextTarget = gameObject;
-  }
+  static void setContextTarget(GameObject *gameObject);
 
   // Queue opening the context menu at window-root scope this frame
   static void queueContextMenuFor(GameObject *gameObject) {
-    contextTarget = gameObject;
+    setContextTarget(gameObject);
     openPopupRequested = true;
   }
 
@@ -27,7 +26,7 @@ public:
   void draw() override;
 
 private:
-  inline static GameObject *contextTarget = nullptr;
+  inline static ObjectHandle contextTarget = {};
   inline static bool openPopupRequested = false;
 };
 } // namespace Magma
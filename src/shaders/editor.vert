@@ -4,9 +4,12 @@ layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec3 inColor;
 
+// VertexLayout of the bound mesh; compact layouts store octahedral normals
+layout(constant_id = 0) const uint VERTEX_LAYOUT = 0;
+
 struct ObjectData {
     mat4 model;
-    mat4 normal;
+    mat3 normal;
     uint objectID;
 };
 
@@ -18,20 +21,39 @@ layout(set = 1, binding = 0, std430) readonly buffer ObjectSSBO {
   ObjectData objects[];
 } objectBuffer;
 
+// Object table slot per instance, grouped contiguously per draw batch
+layout(set = 1, binding = 1, std430) readonly buffer InstanceSSBO {
+  uint slots[];
+} instanceBuffer;
+
+layout(push_constant) uniform Push {
+  uint instanceStride;
+} push;
+
 layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec3 fragPositionWorld;
 layout(location = 2) out vec3 fragNormalWorld;
 
 layout(location = 3) flat out uint fragObjectID;
 
+vec3 octDecode(vec2 e) {
+  vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+  if (n.z < 0.0)
+    n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+  return normalize(n);
+}
+
 void main() {
-  vec4 worldPos = objectBuffer.objects[gl_InstanceIndex].model * vec4(inPosition, 1.0);
+  uint instance = gl_InstanceIndex + gl_DrawID * push.instanceStride;
+  ObjectData object = objectBuffer.objects[instanceBuffer.slots[instance]];
+  vec4 worldPos = object.model * vec4(inPosition, 1.0);
 
-  fragNormalWorld = normalize(mat3(objectBuffer.objects[gl_InstanceIndex].normal) * inNormal);
+  vec3 normal = VERTEX_LAYOUT != 0 ? octDecode(inNormal.xy) : inNormal;
+  fragNormalWorld = normalize(object.normal * normal);
   fragPositionWorld = worldPos.xyz;
   fragColor = vec4(inColor, 1.f);
 
   gl_Position = ubo.projView * worldPos;
 
-  fragObjectID = objectBuffer.objects[gl_InstanceIndex].objectID;
+  fragObjectID = object.objectID;
 }